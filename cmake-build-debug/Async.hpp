@@ -0,0 +1,166 @@
+#ifndef PROBA_ASYNC_HPP
+#define PROBA_ASYNC_HPP
+
+#include "CancellationToken.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+namespace git {
+
+// petlja dogadjaja pozivaoca; nastavci asinhronih operacija se predaju njoj
+class Scheduler {
+public:
+    virtual ~Scheduler() = default;
+    virtual void post(std::function<void()> task) = 0;
+};
+
+namespace detail {
+
+template <typename T>
+struct AsyncStorage {
+    std::unique_ptr<T> value;
+
+    template <typename F>
+    void run(F& function) {
+        value.reset(new T(function()));
+    }
+    T take() {
+        return std::move(*value);
+    }
+};
+
+template <>
+struct AsyncStorage<void> {
+    template <typename F>
+    void run(F& function) {
+        function();
+    }
+    void take() {}
+};
+
+template <typename T>
+struct AsyncState {
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool done = false;
+    std::exception_ptr error;
+    AsyncStorage<T> storage;
+    Scheduler* scheduler = nullptr;
+    CancellationToken token;
+    std::vector<std::function<void()>> continuations;
+
+    void complete() {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            pending.swap(continuations);
+        }
+        ready.notify_all();
+        for (auto& continuation : pending) {
+            dispatch(std::move(continuation));
+        }
+    }
+
+    void dispatch(std::function<void()> continuation) {
+        if (scheduler) {
+            scheduler->post(std::move(continuation));
+        } else {
+            continuation();
+        }
+    }
+};
+
+}
+
+// rezultat operacije koja se izvrsava na IoExecutor-u; nastavci (onComplete i co_await)
+// se izvrsavaju na Scheduler-u pozivaoca, ili odmah u niti izvrsioca ako ga nema
+template <typename T>
+class Async {
+public:
+    // pokrece function na executor-u; izvrsava se samo ako token do tada nije otkazan,
+    // a Branch operacije ga proveravaju i dok rade
+    template <typename Executor, typename F>
+    static Async start(Executor* executor, const void* key, Scheduler* scheduler,
+                       CancellationToken token, F function) {
+        auto state       = std::make_shared<detail::AsyncState<T>>();
+        state->scheduler = scheduler;
+        state->token     = token;
+
+        executor->submit(key, [state, function]() mutable {
+            try {
+                // token vazi i tokom izvrsavanja, preko CancellationScope-a niti
+                CancellationScope scope(state->token);
+                state->token.check();
+                state->storage.run(function);
+            } catch (...) {
+                state->error = std::current_exception();
+            }
+            state->complete();
+        });
+        return Async(state);
+    }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        return _state->done;
+    }
+
+    // blokira do zavrsetka; izuzetak iz operacije se ponovo baca ovde
+    T get() {
+        std::unique_lock<std::mutex> lock(_state->mutex);
+        _state->ready.wait(lock, [this]() { return _state->done; });
+        if (_state->error) {
+            std::rethrow_exception(_state->error);
+        }
+        return _state->storage.take();
+    }
+
+    void onComplete(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (!_state->done) {
+                _state->continuations.push_back(std::move(callback));
+                return;
+            }
+        }
+        _state->dispatch(std::move(callback));
+    }
+
+    // operacija koja ceka u redu se ne pokrece; ona koja je vec pocela se prekida na
+    // sledecoj proveri CancellationScope-a; get() u oba slucaja baca OperationCancelled
+    void cancel() {
+        _state->token.cancel();
+    }
+
+#if defined(__cpp_impl_coroutine)
+    bool await_ready() const {
+        return isReady();
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+        onComplete([handle]() { handle.resume(); });
+    }
+    T await_resume() {
+        return get();
+    }
+#endif
+
+private:
+    explicit Async(std::shared_ptr<detail::AsyncState<T>> state) : _state(std::move(state)) {}
+
+    std::shared_ptr<detail::AsyncState<T>> _state;
+};
+
+}
+
+#endif
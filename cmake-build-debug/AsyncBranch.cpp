@@ -0,0 +1,73 @@
+#include "AsyncBranch.hpp"
+
+#include "Branch.hpp"
+#include "IoExecutor.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+// koliko batch posao cita zna se tek kada Branch napravi plan, pa se naplacuje posle
+template <typename Operation>
+std::function<void()> metered(git::IoExecutor* executor, Operation operation) {
+    return [executor, operation]() {
+        git::IoMeter meter;
+        try {
+            operation();
+        } catch (...) {
+            executor->charge(meter.getBytes());
+            throw;
+        }
+        executor->charge(meter.getBytes());
+    };
+}
+
+}
+
+git::AsyncBranch::AsyncBranch(IoExecutor* executor, Scheduler* scheduler)
+    : _executor(executor), _scheduler(scheduler) {}
+
+git::AsyncBranch::~AsyncBranch() = default;
+
+std::unique_ptr<git::AsyncBranch> git::AsyncBranch::create(IoExecutor* executor,
+                                                          Scheduler* scheduler) {
+    if (!executor) {
+        throw std::invalid_argument("Executor is null.");
+    }
+    return std::unique_ptr<AsyncBranch>(new AsyncBranch(executor, scheduler));
+}
+
+git::Async<void> git::AsyncBranch::checkout(Branch* branch, const Branch* target,
+                                            CancellationToken token) {
+    if (!branch || !target) {
+        throw std::invalid_argument("Branch is null.");
+    }
+    IoExecutor::Lane lane = _executor->lane(IoExecutor::Priority::Batch);
+    return Async<void>::start(&lane, branch->getRepository(), _scheduler, token,
+                              metered(_executor, [branch, target]() {
+                                  branch->checkout(target);
+                              }));
+}
+
+git::Async<void> git::AsyncBranch::executeMerge(Branch* branch, Branch* target,
+                                                CancellationToken token) {
+    if (!branch || !target) {
+        throw std::invalid_argument("Branch is null.");
+    }
+    IoExecutor::Lane lane = _executor->lane(IoExecutor::Priority::Batch);
+    return Async<void>::start(&lane, branch->getRepository(), _scheduler, token,
+                              metered(_executor, [branch, target]() {
+                                  branch->executeMerge(target);
+                              }));
+}
+
+git::Async<std::vector<std::unique_ptr<git::Branch>>> git::AsyncBranch::getAllBranches(
+    Repository* repo, CancellationToken token) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    // listanje je interaktivno i pretice merge/checkout poslove koji jos cekaju
+    IoExecutor::Lane lane = _executor->lane(IoExecutor::Priority::Interactive);
+    return Async<std::vector<std::unique_ptr<Branch>>>::start(
+        &lane, repo, _scheduler, token, [repo]() { return Branch::getAllBranches(repo); });
+}
@@ -0,0 +1,48 @@
+#ifndef PROBA_ASYNCBRANCH_HPP
+#define PROBA_ASYNCBRANCH_HPP
+
+#include "Async.hpp"
+#include "CancellationToken.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class IoExecutor;
+class Repository;
+
+// neblokirajuce verzije Branch operacija: posao ide na IoExecutor (redom po
+// repozitorijumu), a rezultat se ceka preko Async-a (get, onComplete ili co_await);
+// checkout i merge idu kao batch poslovi (procitani bajtovi iz packova se posle posla
+// naplacuju batchIoPerSecond budzetu), a listanje grana kao interaktivni posao; token
+// (ili Async::cancel) prekida i operaciju koja je vec u toku, dok jos nije pocela upis
+// u radni direktorijum; pozivalac mora da drzi Branch i Repository objekte zive do
+// zavrsetka operacije
+class AsyncBranch {
+public:
+    AsyncBranch(const AsyncBranch&)            = delete;
+    AsyncBranch& operator=(const AsyncBranch&) = delete;
+    ~AsyncBranch();
+
+    // scheduler moze biti nullptr: nastavci se tada izvrsavaju u niti izvrsioca
+    static std::unique_ptr<AsyncBranch> create(IoExecutor* executor, Scheduler* scheduler);
+
+    Async<void> checkout(Branch* branch, const Branch* target,
+                         CancellationToken token = CancellationToken());
+    Async<void> executeMerge(Branch* branch, Branch* target,
+                             CancellationToken token = CancellationToken());
+    Async<std::vector<std::unique_ptr<Branch>>> getAllBranches(
+        Repository* repo, CancellationToken token = CancellationToken());
+
+private:
+    AsyncBranch(IoExecutor* executor, Scheduler* scheduler);
+
+    IoExecutor* _executor;
+    Scheduler* _scheduler;
+};
+
+}
+
+#endif
@@ -0,0 +1,320 @@
+#include "BatchCheckout.hpp"
+
+#include "BatchFileWriter.hpp"
+#include "Branch.hpp"
+#include "CancellationToken.hpp"
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool isRegularFile(uint16_t mode) {
+    return mode == GIT_FILEMODE_BLOB || mode == GIT_FILEMODE_BLOB_EXECUTABLE;
+}
+
+std::string parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+void makeDirectories(const std::string& workdir, const std::string& relative) {
+    if (relative.empty()) {
+        return;
+    }
+
+    std::string full = workdir + relative;
+    if (mkdir(full.c_str(), 0777) == 0 || errno == EEXIST) {
+        return;
+    }
+    if (errno != ENOENT) {
+        throw std::runtime_error("Failed to create directory " + full + ": " +
+                                 std::strerror(errno));
+    }
+
+    makeDirectories(workdir, parentOf(relative));
+    if (mkdir(full.c_str(), 0777) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create directory " + full + ": " +
+                                 std::strerror(errno));
+    }
+}
+
+// posle brisanja fajla uklanjamo i roditeljske direktorijume koji su ostali prazni
+void removeEmptyParents(const std::string& workdir, std::string relative) {
+    for (relative = parentOf(relative); !relative.empty(); relative = parentOf(relative)) {
+        if (rmdir((workdir + relative).c_str()) != 0) {
+            return;
+        }
+    }
+}
+
+}
+
+git::BatchCheckout::BatchCheckout(git_repository* repo) : _repo(repo) {}
+
+git::BatchCheckout::~BatchCheckout() {
+    git_tree_free(_targetTree);
+}
+
+std::unique_ptr<git::BatchCheckout> git::BatchCheckout::create(Repository* repo,
+                                                               git_commit* target) {
+    if (!repo) {
+        throw std::invalid_argument("Repository or target commit is null.");
+    }
+    auto checkout    = create(repo->_repo, target);
+    checkout->_owner = repo;
+    return checkout;
+}
+
+std::unique_ptr<git::BatchCheckout> git::BatchCheckout::create(
+    git_repository* repo, git_commit* target, std::shared_ptr<TaskScheduler> scheduler) {
+    if (!repo || !target) {
+        throw std::invalid_argument("Repository or target commit is null.");
+    }
+
+    std::unique_ptr<BatchCheckout> checkout(new BatchCheckout(repo));
+    checkout->_scheduler = std::move(scheduler);
+    checkout->_applicable = checkout->analyze(target);
+    return checkout;
+}
+
+bool git::BatchCheckout::isApplicable() const {
+    return _applicable;
+}
+
+void git::BatchCheckout::setScheduler(std::shared_ptr<TaskScheduler> scheduler) {
+    _scheduler = std::move(scheduler);
+}
+
+bool git::BatchCheckout::analyze(git_commit* target) {
+    git_repository* repo = _repo;
+    if (git_repository_is_bare(repo) || !git_repository_workdir(repo)) {
+        return false;
+    }
+    _workdir = git_repository_workdir(repo);
+
+    git_reference* headRef = nullptr;
+    if (git_repository_head(&headRef, repo) != 0) {
+        return false;
+    }
+
+    git_tree* headTree = nullptr;
+    int error = git_reference_peel(reinterpret_cast<git_object**>(&headTree), headRef,
+                                   GIT_OBJECT_TREE);
+    git_reference_free(headRef);
+    if (error != 0) {
+        return false;
+    }
+
+    if (git_commit_tree(&_targetTree, target) != 0) {
+        git_tree_free(headTree);
+        throw std::runtime_error("Failed to get target tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_diff* diff = nullptr;
+    if (git_diff_tree_to_tree(&diff, repo, headTree, _targetTree, nullptr) != 0) {
+        git_tree_free(headTree);
+        throw std::runtime_error("Failed to diff trees: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_tree_free(headTree);
+
+    bool supported = true;
+    for (size_t i = 0; i < git_diff_num_deltas(diff) && supported; ++i) {
+        const git_diff_delta* delta = git_diff_get_delta(diff, i);
+        switch (delta->status) {
+            case GIT_DELTA_DELETED:
+                supported = isRegularFile(delta->old_file.mode);
+                _removals.push_back(delta->old_file.path);
+                break;
+            case GIT_DELTA_ADDED:
+                supported = isRegularFile(delta->new_file.mode);
+                _writes.push_back(
+                    {delta->new_file.path, delta->new_file.id, delta->new_file.mode, true});
+                break;
+            case GIT_DELTA_MODIFIED:
+                supported = isRegularFile(delta->old_file.mode) &&
+                            isRegularFile(delta->new_file.mode);
+                // O_TRUNC ne menja prava pristupa, pa fajl sa novim modom pravimo iznova
+                if (delta->old_file.mode != delta->new_file.mode) {
+                    _removals.push_back(delta->old_file.path);
+                }
+                _writes.push_back(
+                    {delta->new_file.path, delta->new_file.id, delta->new_file.mode, false});
+                break;
+            default:
+                supported = false;
+                break;
+        }
+    }
+    git_diff_free(diff);
+
+    if (!supported || _removals.size() + _writes.size() < kMinFiles) {
+        return false;
+    }
+
+    return isWorkdirClean();
+}
+
+bool git::BatchCheckout::isWorkdirClean() const {
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    opts.flags              = GIT_STATUS_OPT_EXCLUDE_SUBMODULES;
+
+    git_status_list* status = nullptr;
+    if (git_status_list_new(&status, _repo, &opts) != 0) {
+        throw std::runtime_error("Failed to get status: " +
+                                 std::string(git_error_last()->message));
+    }
+    size_t changes = git_status_list_entrycount(status);
+    git_status_list_free(status);
+    if (changes != 0) {
+        return false;
+    }
+
+    std::set<std::string> removed(_removals.begin(), _removals.end());
+    std::set<std::string> parents;
+    struct stat st;
+    for (const auto& write : _writes) {
+        // nepracen fajl na putanji koju dodajemo; libgit2 ce to prijaviti kao konflikt
+        if (write.added && lstat((_workdir + write.path).c_str(), &st) == 0) {
+            return false;
+        }
+        for (std::string parent = parentOf(write.path); !parent.empty();
+             parent             = parentOf(parent)) {
+            parents.insert(parent);
+        }
+    }
+
+    for (const auto& parent : parents) {
+        if (lstat((_workdir + parent).c_str(), &st) == 0 && !S_ISDIR(st.st_mode) &&
+            removed.count(parent) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void git::BatchCheckout::run() {
+    if (!_applicable) {
+        throw std::logic_error("Batch checkout is not applicable to this tree.");
+    }
+
+    // otkazivanje se proverava izmedju grupa; prekinut checkout ostavlja HEAD i indeks
+    // netaknute, pa ga ponovni checkout (ili git checkout -f) zavrsava
+    for (size_t i = 0; i < _removals.size(); ++i) {
+        if (i % BatchFileWriter::kBatchFiles == 0) {
+            CancellationScope::check();
+        }
+        const std::string& path = _removals[i];
+        if (unlink((_workdir + path).c_str()) != 0 && errno != ENOENT) {
+            throw std::runtime_error("Failed to remove " + path + ": " + std::strerror(errno));
+        }
+        removeEmptyParents(_workdir, path);
+    }
+
+    std::set<std::string> directories;
+    for (const auto& write : _writes) {
+        directories.insert(parentOf(write.path));
+    }
+    for (const auto& directory : directories) {
+        makeDirectories(_workdir, directory);
+    }
+
+    if (!_scheduler && _owner) {
+        _scheduler = TaskScheduler::create(_owner);
+    }
+    auto writer = _scheduler ? BatchFileWriter::create(_scheduler) : BatchFileWriter::create();
+    for (size_t i = 0; i < _writes.size(); ++i) {
+        if (i % BatchFileWriter::kBatchFiles == 0) {
+            CancellationScope::check();
+        }
+        const Write& write = _writes[i];
+        git_blob* blob     = nullptr;
+        if (git_blob_lookup(&blob, _repo, &write.id) != 0) {
+            throw std::runtime_error("Failed to lookup blob for " + write.path + ": " +
+                                     std::string(git_error_last()->message));
+        }
+
+        // primenjuju se isti filteri (crlf, ident...) kao u git_checkout
+        git_buf content              = GIT_BUF_INIT;
+        git_blob_filter_options opts = GIT_BLOB_FILTER_OPTIONS_INIT;
+        int error = git_blob_filter(&content, blob, write.path.c_str(), &opts);
+        git_blob_free(blob);
+        if (error != 0) {
+            throw std::runtime_error("Failed to filter blob for " + write.path + ": " +
+                                     std::string(git_error_last()->message));
+        }
+
+        std::string data(content.ptr, content.size);
+        git_buf_dispose(&content);
+
+        writer->add(_workdir + write.path, std::move(data),
+                    write.mode == GIT_FILEMODE_BLOB_EXECUTABLE ? 0777 : 0666);
+    }
+    writer->sync(_workdir);
+
+    updateIndex();
+}
+
+void git::BatchCheckout::updateIndex() {
+    git_index* index = nullptr;
+    if (git_repository_index(&index, _repo) != 0) {
+        throw std::runtime_error("Failed to get repository index: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    // read_tree cuva stat podatke unosa ciji se OID i mod poklapaju sa stablom, pa upisane
+    // fajlove prvo dodajemo sa novim OID-om i stat podacima, a stablo citamo na kraju;
+    // git_index_add ponistava cache-tree za svoj direktorijum, a read_tree ga gradi ceo,
+    // pa sledeci git_index_write_tree ne mora da hesira nijedan direktorijum
+    struct stat st;
+    for (const auto& write : _writes) {
+        if (lstat((_workdir + write.path).c_str(), &st) != 0) {
+            continue;
+        }
+
+        git_index_entry updated;
+        std::memset(&updated, 0, sizeof(updated));
+        updated.path              = write.path.c_str();
+        updated.id                = write.id;
+        updated.mode              = write.mode;
+        updated.ctime.seconds     = static_cast<int32_t>(st.st_ctim.tv_sec);
+        updated.ctime.nanoseconds = static_cast<uint32_t>(st.st_ctim.tv_nsec);
+        updated.mtime.seconds     = static_cast<int32_t>(st.st_mtim.tv_sec);
+        updated.mtime.nanoseconds = static_cast<uint32_t>(st.st_mtim.tv_nsec);
+        updated.dev               = static_cast<uint32_t>(st.st_dev);
+        updated.ino               = static_cast<uint32_t>(st.st_ino);
+        updated.uid               = st.st_uid;
+        updated.gid               = st.st_gid;
+        updated.file_size         = static_cast<uint32_t>(st.st_size);
+
+        if (git_index_add(index, &updated) != 0) {
+            git_index_free(index);
+            throw std::runtime_error("Failed to update index entry: " +
+                                     std::string(git_error_last()->message));
+        }
+    }
+
+    if (git_index_read_tree(index, _targetTree) != 0) {
+        git_index_free(index);
+        throw std::runtime_error("Failed to read target tree into index: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    if (git_index_write(index) != 0) {
+        git_index_free(index);
+        throw std::runtime_error("Failed to write index: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_index_free(index);
+}
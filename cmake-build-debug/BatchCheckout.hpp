@@ -0,0 +1,66 @@
+#ifndef PROBA_BATCHCHECKOUT_HPP
+#define PROBA_BATCHCHECKOUT_HPP
+
+#include <git2.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+class TaskScheduler;
+
+// brzi checkout za cist radni direktorijum: fajlove pise BatchFileWriter u grupama,
+// a za sve ostale slucajeve (symlinkovi, submoduli, izmene u radnom direktorijumu) ostaje libgit2
+class BatchCheckout {
+public:
+    static constexpr size_t kMinFiles = 64;
+
+    BatchCheckout(const BatchCheckout&)            = delete;
+    BatchCheckout& operator=(const BatchCheckout&) = delete;
+    ~BatchCheckout();
+
+    // fajlove pise preko TaskScheduler-a koji preda pozivalac; bez njega run() pravi
+    // sopstveni, tek kada upis zaista krene
+    static std::unique_ptr<BatchCheckout> create(Repository* repo, git_commit* target);
+    // za repozitorijume bez Repository omotaca, npr. submodule; bez scheduler-a pisac
+    // pravi sopstvene niti
+    static std::unique_ptr<BatchCheckout> create(
+        git_repository* repo, git_commit* target,
+        std::shared_ptr<TaskScheduler> scheduler = nullptr);
+
+    bool isApplicable() const;
+    void setScheduler(std::shared_ptr<TaskScheduler> scheduler);
+    // izmedju grupa fajlova proverava CancellationScope; ne menja HEAD
+    void run();
+
+private:
+    struct Write {
+        std::string path;
+        git_oid id;
+        unsigned int mode;
+        bool added;
+    };
+
+    explicit BatchCheckout(git_repository* repo);
+
+    bool analyze(git_commit* target);
+    bool isWorkdirClean() const;
+    void updateIndex();
+
+    git_repository* _repo;
+    Repository* _owner = nullptr;
+    std::shared_ptr<TaskScheduler> _scheduler;
+    std::string _workdir;
+    git_tree* _targetTree = nullptr;
+    bool _applicable      = false;
+
+    std::vector<std::string> _removals;
+    std::vector<Write> _writes;
+};
+
+}
+
+#endif
@@ -0,0 +1,297 @@
+#include "BatchFileWriter.hpp"
+
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef GIT_USE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace {
+
+const int kOpenFlags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+
+// dopisuje ostatak posle kratkog upisa
+int writeAll(int fd, const char* data, size_t size, size_t offset) {
+    while (offset < size) {
+        ssize_t written = pwrite(fd, data + offset, size - offset, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -errno;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return 0;
+}
+
+std::string describeError(const std::string& path, int error) {
+    return "Failed to write " + path + ": " + std::strerror(error);
+}
+
+#ifdef GIT_USE_IO_URING
+template <typename Prepare>
+void runPhase(io_uring* ring, size_t count, std::vector<int>& results, Prepare prepare) {
+    size_t queued = 0;
+    for (size_t i = 0; i < count; ++i) {
+        io_uring_sqe* sqe = io_uring_get_sqe(ring);
+        if (!sqe) {
+            throw std::runtime_error("io_uring submission queue is full.");
+        }
+        if (!prepare(sqe, i)) {
+            // nema posla za ovaj fajl u ovoj fazi
+            io_uring_prep_nop(sqe);
+            sqe->user_data = UINT64_MAX;
+            ++queued;
+            continue;
+        }
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+        ++queued;
+    }
+
+    int submitted = io_uring_submit_and_wait(ring, static_cast<unsigned>(queued));
+    if (submitted < 0) {
+        throw std::runtime_error("io_uring submit failed: " +
+                                 std::string(std::strerror(-submitted)));
+    }
+
+    for (size_t i = 0; i < queued; ++i) {
+        io_uring_cqe* cqe = nullptr;
+        int error         = io_uring_wait_cqe(ring, &cqe);
+        if (error < 0) {
+            throw std::runtime_error("io_uring wait failed: " + std::string(std::strerror(-error)));
+        }
+        if (cqe->user_data != UINT64_MAX) {
+            results[static_cast<size_t>(cqe->user_data)] = cqe->res;
+        }
+        io_uring_cqe_seen(ring, cqe);
+    }
+}
+#endif
+
+}
+
+git::BatchFileWriter::BatchFileWriter(unsigned int threads,
+                                      std::shared_ptr<TaskScheduler> scheduler)
+    : _threads(threads), _scheduler(std::move(scheduler)) {}
+
+git::BatchFileWriter::~BatchFileWriter() {
+#ifdef GIT_USE_IO_URING
+    if (_ring) {
+        io_uring_queue_exit(static_cast<io_uring*>(_ring));
+        delete static_cast<io_uring*>(_ring);
+    }
+#endif
+}
+
+std::unique_ptr<git::BatchFileWriter> git::BatchFileWriter::create(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return make(threads, nullptr);
+}
+
+std::unique_ptr<git::BatchFileWriter> git::BatchFileWriter::create(
+    std::shared_ptr<TaskScheduler> scheduler) {
+    if (!scheduler) {
+        throw std::invalid_argument("Scheduler is null.");
+    }
+    unsigned int threads = scheduler->getThreadCount();
+    return make(threads, std::move(scheduler));
+}
+
+std::unique_ptr<git::BatchFileWriter> git::BatchFileWriter::make(
+    unsigned int threads, std::shared_ptr<TaskScheduler> scheduler) {
+    std::unique_ptr<BatchFileWriter> writer(new BatchFileWriter(threads, std::move(scheduler)));
+
+#ifdef GIT_USE_IO_URING
+    // kernel moze da zabrani io_uring (seccomp, stariji kernel), tada ostajemo na nitima
+    io_uring* ring = new io_uring;
+    if (io_uring_queue_init(kBatchFiles, ring, 0) == 0) {
+        writer->_ring = ring;
+    } else {
+        delete ring;
+    }
+#endif
+
+    return writer;
+}
+
+void git::BatchFileWriter::add(const std::string& path, std::string data, unsigned int mode) {
+    _pendingBytes += data.size();
+    _pending.push_back(File{path, std::move(data), mode});
+
+    if (_pending.size() >= kBatchFiles || _pendingBytes >= kBatchBytes) {
+        flush();
+    }
+}
+
+void git::BatchFileWriter::flush() {
+    if (_pending.empty()) {
+        return;
+    }
+
+    try {
+        if (_ring) {
+            flushIoUring();
+        } else {
+            flushThreads();
+        }
+    } catch (...) {
+        _pending.clear();
+        _pendingBytes = 0;
+        throw;
+    }
+
+    _written += _pending.size();
+    _pending.clear();
+    _pendingBytes = 0;
+}
+
+void git::BatchFileWriter::flushIoUring() {
+#ifdef GIT_USE_IO_URING
+    io_uring* ring = static_cast<io_uring*>(_ring);
+    size_t count   = _pending.size();
+
+    std::vector<int> fds(count, -1);
+    runPhase(ring, count, fds, [this](io_uring_sqe* sqe, size_t i) {
+        const File& file = _pending[i];
+        io_uring_prep_openat(sqe, AT_FDCWD, file.path.c_str(), kOpenFlags, file.mode);
+        return true;
+    });
+
+    std::vector<int> written(count, 0);
+    runPhase(ring, count, written, [this, &fds](io_uring_sqe* sqe, size_t i) {
+        const File& file = _pending[i];
+        if (fds[i] < 0 || file.data.empty()) {
+            return false;
+        }
+        io_uring_prep_write(sqe, fds[i], file.data.data(),
+                            static_cast<unsigned>(file.data.size()), 0);
+        return true;
+    });
+
+    std::string error;
+    for (size_t i = 0; i < count && error.empty(); ++i) {
+        const File& file = _pending[i];
+        if (fds[i] < 0) {
+            error = describeError(file.path, -fds[i]);
+        } else if (written[i] < 0) {
+            error = describeError(file.path, -written[i]);
+        } else {
+            int result = writeAll(fds[i], file.data.data(), file.data.size(),
+                                  static_cast<size_t>(written[i]));
+            if (result < 0) {
+                error = describeError(file.path, -result);
+            }
+        }
+    }
+
+    std::vector<int> closed(count, 0);
+    runPhase(ring, count, closed, [&fds](io_uring_sqe* sqe, size_t i) {
+        if (fds[i] < 0) {
+            return false;
+        }
+        io_uring_prep_close(sqe, fds[i]);
+        return true;
+    });
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+#endif
+}
+
+void git::BatchFileWriter::flushThreads() {
+    std::mutex errorMutex;
+    std::string error;
+
+    auto write = [this, &errorMutex, &error](size_t i) {
+        const File& file = _pending[i];
+
+        int result = 0;
+        int fd     = ::open(file.path.c_str(), kOpenFlags, file.mode);
+        if (fd < 0) {
+            result = -errno;
+        } else {
+            result = writeAll(fd, file.data.data(), file.data.size(), 0);
+            if (::close(fd) != 0 && result == 0) {
+                result = -errno;
+            }
+        }
+
+        if (result < 0) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (error.empty()) {
+                error = describeError(file.path, -result);
+            }
+        }
+    };
+
+    // sa scheduler-om checkout deli niti sa ostalim masovnim operacijama repozitorijuma
+    if (_scheduler) {
+        size_t grain = std::max<size_t>(1, _pending.size() / (4 * static_cast<size_t>(_threads)));
+        _scheduler->parallelFor(_pending.size(), grain, [&write](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                write(i);
+            }
+        });
+    } else {
+        std::atomic<size_t> next{0};
+        auto work = [this, &next, &write]() {
+            for (size_t i = next++; i < _pending.size(); i = next++) {
+                write(i);
+            }
+        };
+
+        size_t count = std::min<size_t>(_threads, _pending.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < count; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+void git::BatchFileWriter::sync(const std::string& directory) {
+    flush();
+
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + directory + ": " + std::strerror(errno));
+    }
+
+    int result = syncfs(fd);
+    int error  = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("syncfs failed for " + directory + ": " + std::strerror(error));
+    }
+}
+
+bool git::BatchFileWriter::usesIoUring() const {
+    return _ring != nullptr;
+}
+
+size_t git::BatchFileWriter::getWrittenCount() const {
+    return _written;
+}
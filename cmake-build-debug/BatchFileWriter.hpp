@@ -0,0 +1,60 @@
+#ifndef PROBA_BATCHFILEWRITER_HPP
+#define PROBA_BATCHFILEWRITER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class TaskScheduler;
+
+// pravi i upisuje fajlove u grupama: preko io_uring-a kada je dostupan (GIT_USE_IO_URING),
+// inace preko niti zajednickog TaskScheduler-a (ili sopstvenih, bez njega); trajnost se
+// obezbedjuje jednim syncfs pozivom umesto fsync po fajlu
+class BatchFileWriter {
+public:
+    static constexpr size_t kBatchFiles = 256;
+    static constexpr size_t kBatchBytes = 64 * 1024 * 1024;
+
+    BatchFileWriter(const BatchFileWriter&)            = delete;
+    BatchFileWriter& operator=(const BatchFileWriter&) = delete;
+    ~BatchFileWriter();
+
+    static std::unique_ptr<BatchFileWriter> create(unsigned int threads = 0);
+    static std::unique_ptr<BatchFileWriter> create(std::shared_ptr<TaskScheduler> scheduler);
+
+    void add(const std::string& path, std::string data, unsigned int mode);
+    void flush();
+    void sync(const std::string& directory);
+
+    bool usesIoUring() const;
+    size_t getWrittenCount() const;
+
+private:
+    struct File {
+        std::string path;
+        std::string data;
+        unsigned int mode;
+    };
+
+    BatchFileWriter(unsigned int threads, std::shared_ptr<TaskScheduler> scheduler);
+
+    static std::unique_ptr<BatchFileWriter> make(unsigned int threads,
+                                                 std::shared_ptr<TaskScheduler> scheduler);
+
+    void flushIoUring();
+    void flushThreads();
+
+    unsigned int _threads;
+    std::shared_ptr<TaskScheduler> _scheduler;
+    std::vector<File> _pending;
+    size_t _pendingBytes = 0;
+    size_t _written      = 0;
+    void* _ring          = nullptr;
+};
+
+}
+
+#endif
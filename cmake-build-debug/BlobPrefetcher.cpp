@@ -0,0 +1,359 @@
+#include "BlobPrefetcher.hpp"
+
+#include "Branch.hpp"
+#include "PackAccess.hpp"
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+// granica kesa za blobove je globalna za proces; libgit2 nema getter, pa se pamti
+// vrednost aplikacije (podrazumevano 0) i vraca kada se zavrsi poslednji prefetch
+std::mutex cacheMutex;
+size_t cacheUsers     = 0;
+size_t baseCacheLimit = 0;
+
+void applyBlobCacheLimit(size_t limit) {
+    git_libgit2_opts(GIT_OPT_SET_CACHE_OBJECT_LIMIT, GIT_OBJECT_BLOB, limit);
+}
+
+bool isBlobMode(uint16_t mode) {
+    return mode == GIT_FILEMODE_BLOB || mode == GIT_FILEMODE_BLOB_EXECUTABLE ||
+           mode == GIT_FILEMODE_LINK;
+}
+
+void collectBlobs(git_repository* repo, git_tree* from, git_tree* to, bool includeOld,
+                  std::vector<git_oid>& out) {
+    git_diff* diff = nullptr;
+    if (git_diff_tree_to_tree(&diff, repo, from, to, nullptr) != 0) {
+        throw std::runtime_error("Failed to diff trees for prefetch: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    for (size_t i = 0; i < git_diff_num_deltas(diff); ++i) {
+        const git_diff_delta* delta = git_diff_get_delta(diff, i);
+        if (delta->status == GIT_DELTA_DELETED) {
+            continue;
+        }
+        if (isBlobMode(delta->new_file.mode)) {
+            out.push_back(delta->new_file.id);
+        }
+        if (includeOld && delta->status == GIT_DELTA_MODIFIED &&
+            isBlobMode(delta->old_file.mode)) {
+            out.push_back(delta->old_file.id);
+        }
+    }
+
+    git_diff_free(diff);
+}
+
+git_tree* lookupCommitTree(const git_commit* commit) {
+    git_tree* tree = nullptr;
+    if (git_commit_tree(&tree, commit) != 0) {
+        throw std::runtime_error("Failed to get commit tree: " +
+                                 std::string(git_error_last()->message));
+    }
+    return tree;
+}
+
+}
+
+git::BlobPrefetcher::BlobPrefetcher(Repository* repo, const PackAccess* packs, size_t budget)
+    : _repo(repo), _packs(packs), _budget(budget) {}
+
+git::BlobPrefetcher::~BlobPrefetcher() {
+    cancel();
+    wait();
+    git_odb_free(_odb);
+}
+
+std::unique_ptr<git::BlobPrefetcher> git::BlobPrefetcher::create(Repository* repo,
+                                                                 const PackAccess* packs,
+                                                                 size_t budget) {
+    if (!repo || !packs) {
+        throw std::invalid_argument("Repository or pack access is null.");
+    }
+
+    std::unique_ptr<BlobPrefetcher> prefetcher(new BlobPrefetcher(repo, packs, budget));
+    if (git_repository_odb(&prefetcher->_odb, repo->_repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return prefetcher;
+}
+
+void git::BlobPrefetcher::add(const git_oid* oid) {
+    _oids.push_back(*oid);
+}
+
+void git::BlobPrefetcher::addTreeDiff(git_tree* from, git_tree* to) {
+    collectBlobs(_repo->_repo, from, to, false, _oids);
+}
+
+void git::BlobPrefetcher::addCheckout(git_commit* target) {
+    if (!target) {
+        throw std::invalid_argument("Target commit is null.");
+    }
+
+    // bez HEAD-a (unborn grana) checkout pise celo stablo
+    git_tree* headTree     = nullptr;
+    git_reference* headRef = nullptr;
+    if (git_repository_head(&headRef, _repo->_repo) == 0) {
+        git_reference_peel(reinterpret_cast<git_object**>(&headTree), headRef, GIT_OBJECT_TREE);
+        git_reference_free(headRef);
+    }
+
+    git_tree* targetTree = lookupCommitTree(target);
+    try {
+        addTreeDiff(headTree, targetTree);
+    } catch (...) {
+        git_tree_free(targetTree);
+        git_tree_free(headTree);
+        throw;
+    }
+
+    git_tree_free(targetTree);
+    git_tree_free(headTree);
+}
+
+void git::BlobPrefetcher::addMerge(git_commit* ours, git_commit* theirs) {
+    if (!ours || !theirs) {
+        throw std::invalid_argument("Merge commit is null.");
+    }
+
+    git_repository* repo = _repo->_repo;
+
+    git_oid baseId;
+    git_tree* baseTree = nullptr;
+    if (git_merge_base(&baseId, repo, git_commit_id(ours), git_commit_id(theirs)) == 0) {
+        git_commit* base = nullptr;
+        if (git_commit_lookup(&base, repo, &baseId) == 0) {
+            git_commit_tree(&baseTree, base);
+            git_commit_free(base);
+        }
+    }
+
+    git_tree* ourTree   = nullptr;
+    git_tree* theirTree = nullptr;
+    try {
+        ourTree   = lookupCommitTree(ours);
+        theirTree = lookupCommitTree(theirs);
+        collectBlobs(repo, baseTree, ourTree, true, _oids);
+        collectBlobs(repo, baseTree, theirTree, true, _oids);
+    } catch (...) {
+        git_tree_free(theirTree);
+        git_tree_free(ourTree);
+        git_tree_free(baseTree);
+        throw;
+    }
+
+    git_tree_free(theirTree);
+    git_tree_free(ourTree);
+    git_tree_free(baseTree);
+}
+
+std::vector<std::vector<git::BlobPrefetcher::Read>> git::BlobPrefetcher::plan() const {
+    std::vector<git_oid> oids = _oids;
+    std::sort(oids.begin(), oids.end(), [](const git_oid& a, const git_oid& b) {
+        return git_oid_cmp(&a, &b) < 0;
+    });
+    oids.erase(std::unique(oids.begin(), oids.end(),
+                           [](const git_oid& a, const git_oid& b) {
+                               return git_oid_equal(&a, &b) != 0;
+                           }),
+               oids.end());
+
+    const auto& packs = _packs->getPacks();
+    auto packRank     = [&packs](const PackFile* pack) {
+        for (size_t i = 0; i < packs.size(); ++i) {
+            if (packs[i].get() == pack) {
+                return i;
+            }
+        }
+        return packs.size();
+    };
+
+    std::vector<Read> reads;
+    reads.reserve(oids.size());
+    for (const auto& oid : oids) {
+        Read read = {oid, nullptr, 0, 0, 0};
+        if (_packs->locate(&oid, &read.pack, &read.offset)) {
+            read.chainBase = read.pack->getChainBase(read.offset, PackAccess::kMaxDeltaDepth);
+        }
+        reads.push_back(read);
+    }
+
+    // duzine samo planiranih zapisa, do sledeceg planiranog zapisa istog packa; reverse
+    // indeks celog packa bi kostao O(N log N) u velicini packa
+    std::vector<std::pair<const PackFile*, uint64_t>> starts;
+    for (const Read& read : reads) {
+        if (read.pack) {
+            starts.emplace_back(read.pack, read.offset);
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+    for (Read& read : reads) {
+        if (!read.pack) {
+            continue;
+        }
+        auto next   = std::upper_bound(starts.begin(), starts.end(),
+                                       std::make_pair(read.pack, read.offset));
+        bool same   = next != starts.end() && next->first == read.pack;
+        read.length = read.pack->estimateEntryLength(read.offset,
+                                                     same ? next->second : UINT64_MAX);
+    }
+
+    // objekti istog delta lanca idu zajedno, da ih cita ista nit dok je baza u kesu
+    std::sort(reads.begin(), reads.end(), [&packRank](const Read& a, const Read& b) {
+        return std::make_tuple(packRank(a.pack), a.chainBase, a.offset) <
+               std::make_tuple(packRank(b.pack), b.chainBase, b.offset);
+    });
+
+    std::vector<std::vector<Read>> groups;
+    for (const auto& read : reads) {
+        bool sameChain = !groups.empty() && read.pack && groups.back().back().pack == read.pack &&
+                         groups.back().back().chainBase == read.chainBase;
+        if (!sameChain) {
+            groups.emplace_back();
+        }
+        groups.back().push_back(read);
+    }
+
+    return groups;
+}
+
+void git::BlobPrefetcher::setScheduler(std::shared_ptr<TaskScheduler> scheduler) {
+    if (_finished.valid()) {
+        throw std::logic_error("Prefetch is already running.");
+    }
+    _scheduler = std::move(scheduler);
+}
+
+void git::BlobPrefetcher::start(unsigned int threads) {
+    if (_finished.valid()) {
+        throw std::logic_error("Prefetch is already running.");
+    }
+
+    _groups.clear();
+    _plannedBytes = 0;
+    if (_oids.size() < kMinBlobs) {
+        return;
+    }
+
+    _groups = plan();
+    for (const auto& group : _groups) {
+        for (const Read& read : group) {
+            _plannedBytes += read.length;
+        }
+    }
+    if (_groups.empty()) {
+        return;
+    }
+
+    // libgit2 podrazumevano ne kesira blobove; bez ovoga bi checkout ponovo inflate-ovao
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (cacheUsers++ == 0 && baseCacheLimit < kMaxCachedBlobSize) {
+            applyBlobCacheLimit(kMaxCachedBlobSize);
+        }
+        _cacheRaised = true;
+    }
+
+    if (!_scheduler) {
+        _scheduler = TaskScheduler::create(_repo);
+    }
+    size_t count = threads ? threads : _scheduler->getThreadCount();
+    size_t limit = kMaxThreads;
+    count        = std::max<size_t>(1, std::min(std::min(count, limit), _groups.size()));
+
+    _nextGroup = 0;
+    _cancelled = false;
+
+    // jedan posao koji deli citanje na count delova; start() se ne blokira, a checkout
+    // koji ceka na istom scheduler-u i sam obradjuje svoje delove
+    auto done = std::make_shared<std::promise<void>>();
+    _finished = done->get_future();
+    _scheduler->submit([this, count, done]() {
+        try {
+            _scheduler->parallelFor(count, 1, [this](size_t, size_t) { work(); });
+        } catch (...) {
+            // greske citanja prijavice sam checkout/merge
+        }
+        done->set_value();
+    });
+}
+
+void git::BlobPrefetcher::work() {
+    while (!_cancelled) {
+        size_t index = _nextGroup++;
+        if (index >= _groups.size()) {
+            return;
+        }
+
+        const auto& group = _groups[index];
+        if (group.front().pack) {
+            const Read& last = group.back();
+            uint64_t end     = last.offset + last.length;
+            group.front().pack->readahead(group.front().chainBase, end - group.front().chainBase);
+        }
+
+        for (const auto& read : group) {
+            if (_cancelled || _bytes >= _budget) {
+                return;
+            }
+
+            git_odb_object* object = nullptr;
+            if (git_odb_read(&object, _odb, &read.oid) != 0) {
+                // nedostajuci objekat prijavice sam checkout/merge
+                continue;
+            }
+            _bytes += git_odb_object_size(object);
+            ++_count;
+            git_odb_object_free(object);
+        }
+    }
+}
+
+void git::BlobPrefetcher::wait() {
+    if (_finished.valid()) {
+        _finished.wait();
+        _finished = std::future<void>();
+    }
+
+    if (_cacheRaised) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (--cacheUsers == 0 && baseCacheLimit < kMaxCachedBlobSize) {
+            applyBlobCacheLimit(baseCacheLimit);
+        }
+        _cacheRaised = false;
+    }
+}
+
+void git::BlobPrefetcher::setBaseBlobCacheLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    baseCacheLimit = limit;
+    if (cacheUsers == 0 || baseCacheLimit >= kMaxCachedBlobSize) {
+        applyBlobCacheLimit(baseCacheLimit);
+    }
+}
+
+void git::BlobPrefetcher::cancel() {
+    _cancelled = true;
+}
+
+size_t git::BlobPrefetcher::getPrefetchedCount() const {
+    return _count;
+}
+
+size_t git::BlobPrefetcher::getPrefetchedBytes() const {
+    return _bytes;
+}
+
+uint64_t git::BlobPrefetcher::getPlannedBytes() const {
+    return _plannedBytes;
+}
@@ -0,0 +1,95 @@
+#ifndef PROBA_BLOBPREFETCHER_HPP
+#define PROBA_BLOBPREFETCHER_HPP
+
+#include <git2.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace git {
+
+class PackAccess;
+class PackFile;
+class Repository;
+class TaskScheduler;
+
+// cita blobove koje ce checkout ili merge trebati, ali redom kojim stoje u packu; citanje
+// ide na TaskScheduler koji preda pozivalac (isti koji koristi i checkout), a bez njega
+// start() pravi sopstveni
+class BlobPrefetcher {
+public:
+    struct Read {
+        git_oid oid;
+        const PackFile* pack;
+        uint64_t offset;
+        uint64_t chainBase;
+        uint64_t length;
+    };
+
+    static constexpr size_t kDefaultBudget     = 256 * 1024 * 1024;
+    static constexpr size_t kMaxCachedBlobSize = 4 * 1024 * 1024;
+    static constexpr size_t kMaxThreads        = 8;
+    // manju izmenu checkout procita brze nego sto se citanje unapred isplati
+    static constexpr size_t kMinBlobs          = 64;
+
+    BlobPrefetcher(const BlobPrefetcher&)            = delete;
+    BlobPrefetcher& operator=(const BlobPrefetcher&) = delete;
+    ~BlobPrefetcher();
+
+    static std::unique_ptr<BlobPrefetcher> create(Repository* repo, const PackAccess* packs,
+                                                  size_t budget = kDefaultBudget);
+
+    void add(const git_oid* oid);
+    void addTreeDiff(git_tree* from, git_tree* to);
+    void addCheckout(git_commit* target);
+    void addMerge(git_commit* ours, git_commit* theirs);
+
+    std::vector<std::vector<Read>> plan() const;
+
+    void setScheduler(std::shared_ptr<TaskScheduler> scheduler);
+
+    // start() podize globalnu GIT_OPT_SET_CACHE_OBJECT_LIMIT granicu za blobove, a wait()
+    // je vraca kada zavrsi poslednji aktivni prefetcher; aplikacija koja sama podesava
+    // tu granicu treba da je postavi ovde, a ne direktno preko git_libgit2_opts
+    static void setBaseBlobCacheLimit(size_t limit);
+
+    void start(unsigned int threads = 0);
+    void wait();
+    void cancel();
+
+    size_t getPrefetchedCount() const;
+    size_t getPrefetchedBytes() const;
+    // procena (gornja granica) bajtova zapisa u packovima koje plan cita, posle start();
+    // loose objekti se ne broje, a ispod kMinBlobs plana nema
+    uint64_t getPlannedBytes() const;
+
+private:
+    BlobPrefetcher(Repository* repo, const PackAccess* packs, size_t budget);
+
+    void work();
+
+    Repository* _repo;
+    const PackAccess* _packs;
+    size_t _budget;
+    git_odb* _odb = nullptr;
+
+    std::vector<git_oid> _oids;
+    std::vector<std::vector<Read>> _groups;
+    uint64_t _plannedBytes = 0;
+
+    std::atomic<size_t> _nextGroup{0};
+    std::atomic<size_t> _count{0};
+    std::atomic<size_t> _bytes{0};
+    std::atomic<bool> _cancelled{false};
+    bool _cacheRaised = false;
+    std::shared_ptr<TaskScheduler> _scheduler;
+    std::future<void> _finished;
+};
+
+}
+
+#endif
@@ -1,8 +1,88 @@
 #include "Branch.hpp"
 
+#include "BatchCheckout.hpp"
+#include "BlobPrefetcher.hpp"
+#include "CancellationToken.hpp"
+#include "IncrementalTree.hpp"
+#include "IoExecutor.hpp"
+#include "MergeBase.hpp"
+#include "PackAccess.hpp"
+#include "ReflogIndex.hpp"
+#include "TaskScheduler.hpp"
+
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
 
+namespace {
+
+void setHead(git_repository* repo, git_reference* branchRef) {
+    // azuriranje HEAD na novu granu
+    if (git_repository_set_head(repo, git_reference_name(branchRef)) != 0) {
+        throw std::runtime_error("Could not update HEAD to target branch: " +
+                                 std::string(git_error_last()->message));
+    }
+}
+
+// stablo indeksa kao izmena HEAD stabla, pa se upisuju samo dodirnuti direktorijumi;
+// putanje se uzimaju iz celog poredjenja HEAD-a i indeksa, jer checkout merge-a odbija samo
+// staged izmene na putanjama koje sam menja, a ostale moraju uci u merge commit; bez
+// HEAD-a (ili ako to ne uspe) ostaje obican git_index_write_tree
+int writeIndexTree(git_oid* out, git_repository* repo, git_index* index) {
+    git_reference* head = nullptr;
+    git_commit* commit  = nullptr;
+    git_tree* base      = nullptr;
+    if (git_repository_head(&head, repo) == 0 &&
+        git_commit_lookup(&commit, repo, git_reference_target(head)) == 0 &&
+        git_commit_tree(&base, commit) == 0) {
+        try {
+            *out = git::IncrementalTree::write(repo, index, base);
+            git_tree_free(base);
+            git_commit_free(commit);
+            git_reference_free(head);
+            return 0;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    git_tree_free(base);
+    git_commit_free(commit);
+    git_reference_free(head);
+    return git_index_write_tree(out, index);
+}
+
+// indeks merge-a iz memorije ide u radni direktorijum i indeks repozitorijuma, sa
+// konfliktima kao kod git_merge-a; MERGE_HEAD se upisuje tek posle checkout-a, pa
+// prekinut checkout ne ostavlja repozitorijum u stanju merge-a
+void checkoutMerge(git_repository* repo, git_index* merged, const git_oid* theirs) {
+    git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+    opts.checkout_strategy    = GIT_CHECKOUT_SAFE | GIT_CHECKOUT_ALLOW_CONFLICTS;
+    git::CancellationScope::apply(&opts);
+
+    int error = git_checkout_index(repo, merged, &opts);
+    git_index_free(merged);
+    if (error != 0) {
+        git::CancellationScope::rethrowIfCancelled(error);
+        throw std::runtime_error("Failed to check out merge: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    char hex[GIT_OID_HEXSZ + 1] = {};
+    git_oid_fmt(hex, theirs);
+    std::ofstream mergeHead(std::string(git_repository_path(repo)) + "MERGE_HEAD",
+                            std::ios::trunc);
+    mergeHead << hex << "\n";
+    if (!mergeHead.flush()) {
+        throw std::runtime_error("Failed to write MERGE_HEAD.");
+    }
+}
+
+int collectMergeHead(const git_oid* oid, void* payload) {
+    static_cast<std::vector<git_oid>*>(payload)->push_back(*oid);
+    return 0;
+}
+
+}
+
 git::Branch::Branch(git_reference* branch, Repository* repo) : _branch(branch), _repo(repo) {
     git_object* commit = nullptr;
     if (git_reference_peel(&commit, _branch, GIT_OBJECT_COMMIT) != 0) {
@@ -71,6 +151,10 @@ std::vector<std::unique_ptr<git::Branch>> git::Branch::getAllBranches(Repository
 
     while (git_branch_next(&branchRef, &branchType, iterator) == 0) {
         branches.push_back(create(branchRef, repo));
+        if (CancellationScope::isCancelled()) {
+            git_branch_iterator_free(iterator);
+            CancellationScope::check();
+        }
     }
 
     git_branch_iterator_free(iterator);
@@ -100,22 +184,51 @@ void git::Branch::checkout(const git::Branch* targetBranch) {
         throw std::invalid_argument("Target branch reference is null.");
     }
 
-    // azuriranje HEAD na novu granu
-    int error =
-        git_repository_set_head(this->getRepository()->_repo, git_reference_name(branchRef));
-    if (error != 0) {
-        throw std::runtime_error("Could not update HEAD to target branch: " +
-                                 std::string(git_error_last()->message));
+    // veliki checkout cistog radnog direktorijuma pisemo sami, u grupama
+    auto batch =
+        BatchCheckout::create(this->getRepository(), targetBranch->getLastCommit()->_commit);
+
+    // blobove za novo stablo citamo unapred, redom iz packa, dok checkout pise fajlove
+    auto packs      = PackAccess::forRepository(this->getRepository(), AccessPattern::Sequential);
+    auto prefetcher = BlobPrefetcher::create(this->getRepository(), packs.get());
+    prefetcher->addCheckout(targetBranch->getLastCommit()->_commit);
+
+    // niti ovog checkout-a dele citanje unapred i upis; bez upisa u grupama prefetcher ih
+    // pravi sam, i to samo ako ima sta da cita
+    std::shared_ptr<TaskScheduler> scheduler;
+    if (batch->isApplicable()) {
+        scheduler = TaskScheduler::create(this->getRepository());
+        batch->setScheduler(scheduler);
+        prefetcher->setScheduler(scheduler);
+    }
+    prefetcher->start();
+    IoMeter::record(prefetcher->getPlannedBytes());
+
+    // otkazivanje: pre upisa, izmedju grupa fajlova u BatchCheckout-u i u libgit2 notify
+    // fazi, koja prethodi upisu; HEAD se menja tek posle upisa, pa greska ili otkazivanje
+    // usred upisa ne ostavljaju HEAD na novoj grani sa starim radnim direktorijumom
+    CancellationScope::check();
+    if (batch->isApplicable()) {
+        batch->run();
+        setHead(this->getRepository()->_repo, branchRef);
+        return;
     }
 
     git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
     opts.checkout_strategy    = GIT_CHECKOUT_SAFE;
+    CancellationScope::apply(&opts);
 
     // prebacivanje radnog direktorijuma
-    error = git_checkout_head(this->getRepository()->_repo, &opts);
+    int error = git_checkout_tree(this->getRepository()->_repo,
+                                  reinterpret_cast<git_object*>(
+                                      targetBranch->getLastCommit()->_commit),
+                                  &opts);
     if (error != 0) {
+        CancellationScope::rethrowIfCancelled(error);
         throw std::runtime_error("Checkout failed: " + std::string(git_error_last()->message));
     }
+
+    setHead(this->getRepository()->_repo, branchRef);
 }
 std::string git::Branch::getBranchName() const {
     const char* branch_name = nullptr;
@@ -132,17 +245,34 @@ void git::Branch::executeMerge(Branch* targetBranch) {
     if (!targetBranch) {
         throw std::invalid_argument("Target branch is null.");
     }
+    CancellationScope::check();
     if (performFastforward(targetBranch)) {
         return;
     }
 
-    executeMergeCommit();
+    auto packs      = PackAccess::forRepository(this->getRepository(), AccessPattern::Sequential);
+    auto prefetcher = BlobPrefetcher::create(this->getRepository(), packs.get());
+    prefetcher->addMerge(getLastCommit()->_commit, targetBranch->getLastCommit()->_commit);
+    prefetcher->start();
+    IoMeter::record(prefetcher->getPlannedBytes());
+
+    // baze i virtuelna baza unakrsnih merge-ova dolaze iz MergeBase-a (redosled po
+    // generacijama, kesirana virtuelna stabla) umesto iz rekurzije git_merge-a
+    git_repository* repo = this->getRepository()->_repo;
+    git_oid ours;
+    if (git_reference_name_to_id(&ours, repo, "HEAD") != 0) {
+        throw std::runtime_error("Failed to get HEAD commit.");
+    }
+    const git_oid* theirs = git_commit_id(targetBranch->getLastCommit()->_commit);
+    checkoutMerge(repo, MergeBase::create(this->getRepository())->merge(&ours, theirs), theirs);
+    prefetcher.reset();
 
     auto conflicts = getConflictingFiles();
     if (!conflicts.empty()) {
         throw std::runtime_error("Merge completed with conflicts. Files in conflict: " +
                                  std::to_string(conflicts.size()));
     }
+    executeMergeCommit();
 }
 bool git::Branch::performFastforward(Branch* targetBranch) {
     if (!targetBranch) {
@@ -172,6 +302,10 @@ bool git::Branch::performFastforward(Branch* targetBranch) {
     }
 
     if (analysis & GIT_MERGE_ANALYSIS_FASTFORWARD) {
+        if (CancellationScope::isCancelled()) {
+            git_annotated_commit_free(annotatedTarget);
+            CancellationScope::check();
+        }
         if (git_repository_set_head(repo, git_reference_name(_branch)) != 0) {
             git_annotated_commit_free(annotatedTarget);
             throw std::runtime_error("Fast-forward failed: " +
@@ -198,12 +332,8 @@ bool git::Branch::performFastforward(Branch* targetBranch) {
 void git::Branch::executeMergeCommit() {
     git_repository* repo = this->getRepository()->_repo;
 
+    // indeks je vec spojen (checkoutMerge); commit se zavrsava bez provera prekida
     git_index* index = nullptr;
-    if (git_merge(repo, nullptr, 0, nullptr, nullptr) != 0) {
-        throw std::runtime_error("Failed to prepare merge: " +
-                                 std::string(git_error_last()->message));
-    }
-
     if (git_repository_index(&index, repo) != 0) {
         throw std::runtime_error("Failed to get repository index: " +
                                  std::string(git_error_last()->message));
@@ -218,7 +348,7 @@ void git::Branch::executeMergeCommit() {
     git_oid tree_oid, commit_oid;
     git_tree* tree = nullptr;
 
-    if (git_index_write_tree(&tree_oid, index) != 0) {
+    if (writeIndexTree(&tree_oid, repo, index) != 0) {
         git_index_free(index);
         throw std::runtime_error("Failed to write tree: " +
                                  std::string(git_error_last()->message));
@@ -240,8 +370,28 @@ void git::Branch::executeMergeCommit() {
         throw std::runtime_error("Failed to get HEAD commit.");
     }
 
-    if (git_commit_create_v(
-            &commit_oid, repo, "HEAD", nullptr, nullptr, nullptr, message, tree, 1, parent) != 0) {
+    // ostali roditelji su iz MERGE_HEAD koji je upisao checkoutMerge
+    std::vector<git_oid> mergeHeads;
+    git_repository_mergehead_foreach(repo, collectMergeHead, &mergeHeads);
+    std::vector<const git_commit*> parents = {parent};
+    git_signature* signature               = nullptr;
+    int error                              = git_signature_default(&signature, repo);
+    for (size_t i = 0; error == 0 && i < mergeHeads.size(); ++i) {
+        git_commit* mergeParent = nullptr;
+        error                   = git_commit_lookup(&mergeParent, repo, &mergeHeads[i]);
+        if (error == 0) {
+            parents.push_back(mergeParent);
+        }
+    }
+    if (error == 0) {
+        error = git_commit_create(&commit_oid, repo, "HEAD", signature, signature, nullptr,
+                                  message, tree, parents.size(), parents.data());
+    }
+    git_signature_free(signature);
+    for (size_t i = 1; i < parents.size(); ++i) {
+        git_commit_free(const_cast<git_commit*>(parents[i]));
+    }
+    if (error != 0) {
         git_tree_free(tree);
         git_index_free(index);
         git_reference_free(headRef);
@@ -249,6 +399,14 @@ void git::Branch::executeMergeCommit() {
         throw std::runtime_error("Failed to create merge commit: " +
                                  std::string(git_error_last()->message));
     }
+    git_repository_state_cleanup(repo);
+
+    // indeks reflog-a je samo ubrzanje: ako dopisivanje ne uspe, reflog je noviji od
+    // indeksa i ReflogIndex ga pri sledecem citanju gradi iznova
+    try {
+        ReflogIndex::record(this->getRepository(), git_reference_name(headRef), &commit_oid);
+    } catch (const std::runtime_error&) {
+    }
 
     git_tree_free(tree);
     git_index_free(index);
@@ -280,6 +438,11 @@ std::vector<std::string> git::Branch::getConflictingFiles() const {
         if (ours) {
             conflictingFiles.push_back(ours->path);
         }
+        if (CancellationScope::isCancelled()) {
+            git_index_conflict_iterator_free(conflictIter);
+            git_index_free(index);
+            CancellationScope::check();
+        }
     }
 
     git_index_conflict_iterator_free(conflictIter);
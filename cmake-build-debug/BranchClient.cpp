@@ -0,0 +1,107 @@
+#include "BranchClient.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+git::BranchClient::BranchClient(int fd) : _fd(fd) {}
+
+git::BranchClient::~BranchClient() {
+    ::close(_fd);
+}
+
+std::unique_ptr<git::BranchClient> git::BranchClient::connect(const std::string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to connect to " + socketPath + ": " +
+                                 std::strerror(error));
+    }
+    return std::unique_ptr<BranchClient>(new BranchClient(fd));
+}
+
+git::BranchStatus git::BranchClient::call(const BranchMessage& request, BranchMessage& response) {
+    BranchMessage::send(_fd, request);
+    if (!BranchMessage::receive(_fd, &response)) {
+        throw std::runtime_error("Branch daemon closed the connection.");
+    }
+
+    auto status = static_cast<BranchStatus>(response.getU8());
+    if (status == BranchStatus::Error) {
+        throw std::runtime_error("Branch daemon error: " + response.getString());
+    }
+    return status;
+}
+
+std::vector<std::pair<std::string, git_oid>> git::BranchClient::listBranches() {
+    BranchMessage request, response;
+    request.putU8(static_cast<uint8_t>(BranchOpcode::ListBranches));
+    call(request, response);
+
+    uint32_t count = response.getU32();
+    std::vector<std::pair<std::string, git_oid>> branches;
+    branches.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name = response.getString();
+        branches.emplace_back(std::move(name), response.getOid());
+    }
+    return branches;
+}
+
+bool git::BranchClient::getTip(const std::string& branch, git_oid* oid) {
+    BranchMessage request, response;
+    request.putU8(static_cast<uint8_t>(BranchOpcode::GetTip));
+    request.putString(branch);
+    if (call(request, response) == BranchStatus::NotFound) {
+        return false;
+    }
+    *oid = response.getOid();
+    return true;
+}
+
+std::pair<uint64_t, uint64_t> git::BranchClient::getAheadBehind(const std::string& branch,
+                                                               const std::string& upstream) {
+    BranchMessage request, response;
+    request.putU8(static_cast<uint8_t>(BranchOpcode::AheadBehind));
+    request.putString(branch);
+    request.putString(upstream);
+    if (call(request, response) == BranchStatus::NotFound) {
+        throw std::invalid_argument("Branch not found: " + response.getString());
+    }
+
+    uint64_t ahead = response.getU64();
+    return {ahead, response.getU64()};
+}
+
+git::Mergeability git::BranchClient::getMergeability(const std::string& ours,
+                                                     const std::string& theirs) {
+    BranchMessage request, response;
+    request.putU8(static_cast<uint8_t>(BranchOpcode::Mergeability));
+    request.putString(ours);
+    request.putString(theirs);
+    if (call(request, response) == BranchStatus::NotFound) {
+        throw std::invalid_argument("Branch not found: " + response.getString());
+    }
+    return static_cast<Mergeability>(response.getU8());
+}
+
+void git::BranchClient::refresh() {
+    BranchMessage request, response;
+    request.putU8(static_cast<uint8_t>(BranchOpcode::Refresh));
+    call(request, response);
+}
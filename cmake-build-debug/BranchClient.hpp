@@ -0,0 +1,49 @@
+#ifndef PROBA_BRANCHCLIENT_HPP
+#define PROBA_BRANCHCLIENT_HPP
+
+#include <git2.h>
+
+#include "BranchProtocol.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace git {
+
+// tanak klijent za BranchDaemon; jedna veza, zahtevi jedan za drugim
+class BranchClient {
+public:
+    BranchClient(const BranchClient&)            = delete;
+    BranchClient& operator=(const BranchClient&) = delete;
+    ~BranchClient();
+
+    static std::unique_ptr<BranchClient> connect(const std::string& socketPath);
+
+    std::vector<std::pair<std::string, git_oid>> listBranches();
+
+    // false ako grana ne postoji
+    bool getTip(const std::string& branch, git_oid* oid);
+
+    // koliko commit-a branch ima, a upstream nema, i obrnuto
+    std::pair<uint64_t, uint64_t> getAheadBehind(const std::string& branch,
+                                                 const std::string& upstream);
+
+    Mergeability getMergeability(const std::string& ours, const std::string& theirs);
+
+    // snimak referenci se osvezava odmah, bez cekanja na promenu mtime-a
+    void refresh();
+
+private:
+    explicit BranchClient(int fd);
+
+    BranchStatus call(const BranchMessage& request, BranchMessage& response);
+
+    int _fd;
+};
+
+}
+
+#endif
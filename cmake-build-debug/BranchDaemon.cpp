@@ -0,0 +1,359 @@
+#include "BranchDaemon.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string pairKey(const git_oid& a, const git_oid& b) {
+    std::string key(reinterpret_cast<const char*>(a.id), sizeof(a.id));
+    key.append(reinterpret_cast<const char*>(b.id), sizeof(b.id));
+    return key;
+}
+
+void appendStat(const std::string& path, std::string& signature) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        signature += "-;";
+        return;
+    }
+    signature += std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec) +
+                 ":" + std::to_string(st.st_size) + ";";
+}
+
+// reference se upisuju preko lock fajla i rename-a, pa svaka izmena menja mtime
+// direktorijuma u kome je referenca
+void appendDirectories(const std::string& directory, std::string& signature) {
+    appendStat(directory, signature);
+
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return;
+    }
+    std::vector<std::string> children;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        struct stat st;
+        std::string path = directory + "/" + name;
+        if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            children.push_back(path);
+        }
+    }
+    closedir(dir);
+
+    std::sort(children.begin(), children.end());
+    for (const std::string& child : children) {
+        appendDirectories(child, signature);
+    }
+}
+
+}
+
+git::BranchDaemon::BranchDaemon(Repository* repo, const std::string& socketPath)
+    : _repo(repo), _socketPath(socketPath) {}
+
+git::BranchDaemon::~BranchDaemon() {
+    stop();
+    clearCaches();
+}
+
+std::unique_ptr<git::BranchDaemon> git::BranchDaemon::create(Repository* repo,
+                                                            const std::string& socketPath) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::unique_ptr<BranchDaemon> daemon(new BranchDaemon(repo, socketPath));
+    daemon->refresh();
+    daemon->listen();
+    return daemon;
+}
+
+void git::BranchDaemon::listen() {
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    if (_socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + _socketPath);
+    }
+    std::memcpy(address.sun_path, _socketPath.c_str(), _socketPath.size() + 1);
+
+    _listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0) {
+        throw std::runtime_error("Failed to create socket: " + std::string(std::strerror(errno)));
+    }
+
+    // socket koji je ostao od prethodnog procesa
+    unlink(_socketPath.c_str());
+    if (bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(_listenFd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(_listenFd);
+        _listenFd = -1;
+        throw std::runtime_error("Failed to listen on " + _socketPath + ": " +
+                                 std::strerror(error));
+    }
+    _running = true;
+}
+
+void git::BranchDaemon::serve() {
+    while (_running) {
+        int fd = accept4(_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (!_running) {
+                break;
+            }
+            throw std::runtime_error("Accept failed: " + std::string(std::strerror(errno)));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_connectionMutex);
+            if (!_running) {
+                ::close(fd);
+                break;
+            }
+            _connections.push_back(fd);
+        }
+        std::thread(&BranchDaemon::handleConnection, this, fd).detach();
+    }
+}
+
+void git::BranchDaemon::stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+
+    // shutdown budi accept i read u nitima veza
+    shutdown(_listenFd, SHUT_RDWR);
+    std::unique_lock<std::mutex> lock(_connectionMutex);
+    for (int fd : _connections) {
+        shutdown(fd, SHUT_RDWR);
+    }
+    _idle.wait(lock, [this]() { return _connections.empty(); });
+    lock.unlock();
+
+    ::close(_listenFd);
+    _listenFd = -1;
+    unlink(_socketPath.c_str());
+}
+
+size_t git::BranchDaemon::getRequestCount() const {
+    return _requests;
+}
+
+void git::BranchDaemon::handleConnection(int fd) {
+    BranchMessage request;
+    try {
+        while (BranchMessage::receive(fd, &request)) {
+            BranchMessage response;
+            try {
+                handle(request, response);
+            } catch (const std::exception& e) {
+                response = BranchMessage();
+                response.putU8(static_cast<uint8_t>(BranchStatus::Error));
+                response.putString(e.what());
+            }
+            BranchMessage::send(fd, response);
+            ++_requests;
+        }
+    } catch (const std::exception&) {
+        // neispravan klijent ili prekinuta veza: zatvara se samo ta veza
+    }
+
+    ::close(fd);
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    _connections.erase(std::find(_connections.begin(), _connections.end(), fd));
+    _idle.notify_all();
+}
+
+void git::BranchDaemon::handle(BranchMessage& request, BranchMessage& response) {
+    auto opcode = static_cast<BranchOpcode>(request.getU8());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (opcode == BranchOpcode::Refresh) {
+        refresh();
+        response.putU8(static_cast<uint8_t>(BranchStatus::Ok));
+        return;
+    }
+    refreshIfChanged();
+
+    switch (opcode) {
+    case BranchOpcode::ListBranches:
+        response.putU8(static_cast<uint8_t>(BranchStatus::Ok));
+        response.putU32(static_cast<uint32_t>(_tips.size()));
+        for (const Tip& tip : _tips) {
+            response.putString(tip.name);
+            response.putOid(tip.oid);
+        }
+        return;
+
+    case BranchOpcode::GetTip: {
+        const git_oid* tip = findTip(request.getString());
+        if (!tip) {
+            response.putU8(static_cast<uint8_t>(BranchStatus::NotFound));
+            return;
+        }
+        response.putU8(static_cast<uint8_t>(BranchStatus::Ok));
+        response.putOid(*tip);
+        return;
+    }
+
+    case BranchOpcode::AheadBehind:
+    case BranchOpcode::Mergeability: {
+        std::string first  = request.getString();
+        std::string second = request.getString();
+        const git_oid* a   = findTip(first);
+        const git_oid* b   = findTip(second);
+        if (!a || !b) {
+            response.putU8(static_cast<uint8_t>(BranchStatus::NotFound));
+            response.putString(!a ? first : second);
+            return;
+        }
+
+        response.putU8(static_cast<uint8_t>(BranchStatus::Ok));
+        if (opcode == BranchOpcode::AheadBehind) {
+            uint64_t ahead = 0, behind = 0;
+            aheadBehind(*a, *b, &ahead, &behind);
+            response.putU64(ahead);
+            response.putU64(behind);
+        } else {
+            response.putU8(static_cast<uint8_t>(mergeability(*a, *b)));
+        }
+        return;
+    }
+
+    default:
+        throw std::runtime_error("Unknown opcode " +
+                                 std::to_string(static_cast<unsigned>(opcode)));
+    }
+}
+
+std::string git::BranchDaemon::computeSignature() const {
+    std::string common = git_repository_commondir(_repo->_repo);
+    std::string signature;
+    appendStat(common + "packed-refs", signature);
+    appendDirectories(common + "refs/heads", signature);
+    // snapshot sadrzi i remote-tracking grane (GIT_BRANCH_ALL), pa i fetch osvezava
+    appendDirectories(common + "refs/remotes", signature);
+    return signature;
+}
+
+void git::BranchDaemon::refreshIfChanged() {
+    if (computeSignature() != _signature) {
+        refresh();
+    }
+}
+
+void git::BranchDaemon::refresh() {
+    // potpis pre citanja: izmena tokom citanja izaziva jos jedno osvezavanje
+    _signature = computeSignature();
+
+    std::vector<Tip> tips;
+    for (const auto& branch : Branch::getAllBranches(_repo)) {
+        tips.push_back({branch->getBranchName(), *git_commit_id(branch->getLastCommit()->_commit)});
+    }
+    std::sort(tips.begin(), tips.end(),
+              [](const Tip& a, const Tip& b) { return a.name < b.name; });
+
+    _tips.swap(tips);
+    _byName.clear();
+    for (size_t i = 0; i < _tips.size(); ++i) {
+        _byName[_tips[i].name] = i;
+    }
+
+    // kesevi su po OID-ovima, pa ostaju ispravni; brisu se samo kada previse narastu
+    if (_aheadBehind.size() + _mergeability.size() + _commits.size() > kCacheLimit) {
+        clearCaches();
+    }
+}
+
+const git_oid* git::BranchDaemon::findTip(const std::string& name) const {
+    auto found = _byName.find(name);
+    return found == _byName.end() ? nullptr : &_tips[found->second].oid;
+}
+
+void git::BranchDaemon::aheadBehind(const git_oid& a, const git_oid& b, uint64_t* ahead,
+                                    uint64_t* behind) {
+    std::string key = pairKey(a, b);
+    auto cached     = _aheadBehind.find(key);
+    if (cached == _aheadBehind.end()) {
+        size_t forward = 0, backward = 0;
+        if (git_graph_ahead_behind(&forward, &backward, _repo->_repo, &a, &b) != 0) {
+            throw std::runtime_error("Failed to count ahead/behind: " +
+                                     std::string(git_error_last()->message));
+        }
+        cached = _aheadBehind.emplace(key, std::make_pair(forward, backward)).first;
+    }
+    *ahead  = cached->second.first;
+    *behind = cached->second.second;
+}
+
+git::Mergeability git::BranchDaemon::mergeability(const git_oid& ours, const git_oid& theirs) {
+    std::string key = pairKey(ours, theirs);
+    auto cached     = _mergeability.find(key);
+    if (cached != _mergeability.end()) {
+        return cached->second;
+    }
+
+    Mergeability result;
+    if (git_oid_equal(&ours, &theirs) ||
+        git_graph_descendant_of(_repo->_repo, &ours, &theirs) == 1) {
+        result = Mergeability::UpToDate;
+    } else if (git_graph_descendant_of(_repo->_repo, &theirs, &ours) == 1) {
+        result = Mergeability::FastForward;
+    } else {
+        // merge u memoriji, bez diranja radnog direktorijuma i indeksa
+        git_index* index = nullptr;
+        if (git_merge_commits(&index, _repo->_repo, lookupCommit(ours), lookupCommit(theirs),
+                              nullptr) != 0) {
+            throw std::runtime_error("Failed to merge commits: " +
+                                     std::string(git_error_last()->message));
+        }
+        result = git_index_has_conflicts(index) ? Mergeability::Conflicts : Mergeability::Clean;
+        git_index_free(index);
+    }
+
+    _mergeability.emplace(key, result);
+    return result;
+}
+
+git_commit* git::BranchDaemon::lookupCommit(const git_oid& oid) {
+    std::string key(reinterpret_cast<const char*>(oid.id), sizeof(oid.id));
+    auto cached = _commits.find(key);
+    if (cached != _commits.end()) {
+        return cached->second;
+    }
+
+    git_commit* commit = nullptr;
+    if (git_commit_lookup(&commit, _repo->_repo, &oid) != 0) {
+        throw std::runtime_error("Failed to lookup commit: " +
+                                 std::string(git_error_last()->message));
+    }
+    _commits.emplace(key, commit);
+    return commit;
+}
+
+void git::BranchDaemon::clearCaches() {
+    for (auto& entry : _commits) {
+        git_commit_free(entry.second);
+    }
+    _commits.clear();
+    _aheadBehind.clear();
+    _mergeability.clear();
+}
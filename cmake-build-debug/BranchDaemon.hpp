@@ -0,0 +1,88 @@
+#ifndef PROBA_BRANCHDAEMON_HPP
+#define PROBA_BRANCHDAEMON_HPP
+
+#include <git2.h>
+
+#include "BranchProtocol.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// rezidentni servis za upite nad granama preko lokalnog Unix socket-a; drzi otvoren
+// Repository, snimak referenci i kes rezultata, pa upit ne otvara repozitorijum niti
+// pravi Branch objekte; snimak se osvezava kada se promeni mtime nekog direktorijuma
+// pod refs/heads i refs/remotes (snimak sadrzi i remote-tracking grane) ili packed-refs
+class BranchDaemon {
+public:
+    static constexpr size_t kCacheLimit = 65536;
+
+    BranchDaemon(const BranchDaemon&)            = delete;
+    BranchDaemon& operator=(const BranchDaemon&) = delete;
+    ~BranchDaemon();
+
+    static std::unique_ptr<BranchDaemon> create(Repository* repo, const std::string& socketPath);
+
+    // blokira dok se ne pozove stop() iz druge niti
+    void serve();
+    void stop();
+
+    size_t getRequestCount() const;
+
+private:
+    struct Tip {
+        std::string name;
+        git_oid oid;
+    };
+
+    BranchDaemon(Repository* repo, const std::string& socketPath);
+
+    void listen();
+    void handleConnection(int fd);
+    void handle(BranchMessage& request, BranchMessage& response);
+
+    void refreshIfChanged();
+    void refresh();
+    std::string computeSignature() const;
+    const git_oid* findTip(const std::string& name) const;
+
+    void aheadBehind(const git_oid& a, const git_oid& b, uint64_t* ahead, uint64_t* behind);
+    Mergeability mergeability(const git_oid& ours, const git_oid& theirs);
+    git_commit* lookupCommit(const git_oid& oid);
+    void clearCaches();
+
+    Repository* _repo;
+    std::string _socketPath;
+    int _listenFd = -1;
+    std::atomic<bool> _running{false};
+    std::atomic<size_t> _requests{0};
+
+    // veze se obradjuju u odvojenim nitima; stop() ih zatvara i ceka da sve zavrse
+    std::mutex _connectionMutex;
+    std::condition_variable _idle;
+    std::vector<int> _connections;
+
+    // stanje ispod _mutex-a: snimak referenci i kesevi vezani za OID-ove
+    std::mutex _mutex;
+    std::string _signature;
+    std::vector<Tip> _tips;
+    std::map<std::string, size_t> _byName;
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> _aheadBehind;
+    std::unordered_map<std::string, Mergeability> _mergeability;
+    std::unordered_map<std::string, git_commit*> _commits;
+};
+
+}
+
+#endif
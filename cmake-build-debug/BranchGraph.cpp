@@ -0,0 +1,165 @@
+#include "BranchGraph.hpp"
+
+#include "Branch.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+void walkCommits(git_repository* repo, const std::vector<git_oid>& tips,
+                 const std::vector<git_oid>& hidden, unsigned int sorting,
+                 std::vector<git_oid>& out) {
+    git_revwalk* walk = nullptr;
+    if (git_revwalk_new(&walk, repo) != 0) {
+        throw std::runtime_error("Failed to create revision walker: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    int error = git_revwalk_sorting(walk, sorting);
+    for (size_t i = 0; error == 0 && i < tips.size(); ++i) {
+        error = git_revwalk_push(walk, &tips[i]);
+    }
+    for (size_t i = 0; error == 0 && i < hidden.size(); ++i) {
+        error = git_revwalk_hide(walk, &hidden[i]);
+    }
+    if (error != 0) {
+        git_revwalk_free(walk);
+        throw std::runtime_error("Failed to set up revision walk: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_oid oid;
+    while ((error = git_revwalk_next(&oid, walk)) == 0) {
+        out.push_back(oid);
+    }
+    git_revwalk_free(walk);
+
+    if (error != GIT_ITEROVER) {
+        throw std::runtime_error("Revision walk failed: " +
+                                 std::string(git_error_last()->message));
+    }
+}
+
+std::vector<git_oid> collectTips(const std::vector<std::unique_ptr<git::Branch>>& branches) {
+    std::vector<git_oid> tips;
+    tips.reserve(branches.size());
+    for (const auto& branch : branches) {
+        tips.push_back(*git_commit_id(branch->getLastCommit()->_commit));
+    }
+    return tips;
+}
+
+}
+
+git::OidSet git::BranchGraph::getReachableCommits(Repository* repo,
+                                                  const std::vector<git_oid>& tips,
+                                                  const std::vector<git_oid>& hidden) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::vector<git_oid> commits;
+    walkCommits(repo->_repo, tips, hidden, GIT_SORT_NONE, commits);
+
+    OidSet reachable;
+    reachable.reserve(commits.size());
+    for (const git_oid& oid : commits) {
+        reachable.insert(&oid);
+    }
+    reachable.normalize();
+    return reachable;
+}
+
+std::vector<std::unique_ptr<git::Branch>> git::BranchGraph::getMergedBranches(
+    Repository* repo, const Branch* target) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (!target) {
+        throw std::invalid_argument("Target branch is null.");
+    }
+
+    auto branches          = Branch::getAllBranches(repo);
+    std::string targetName = target->getBranchName();
+    git_oid targetTip      = *git_commit_id(target->getLastCommit()->_commit);
+
+    // setnja samo kroz commit-e koje target nema, umesto kroz celu istoriju targeta
+    OidSet unmerged = getReachableCommits(repo, collectTips(branches), {targetTip});
+
+    std::vector<std::unique_ptr<Branch>> merged;
+    for (auto& branch : branches) {
+        if (branch->getBranchName() == targetName) {
+            continue;
+        }
+        if (!unmerged.contains(git_commit_id(branch->getLastCommit()->_commit))) {
+            merged.push_back(std::move(branch));
+        }
+    }
+    return merged;
+}
+
+std::vector<std::unique_ptr<git::Branch>> git::BranchGraph::getBranchesContaining(
+    Repository* repo, const git_oid* commit) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (!commit) {
+        throw std::invalid_argument("Commit id is null.");
+    }
+
+    auto branches = Branch::getAllBranches(repo);
+
+    // region = commit-i grana koji nisu preci trazenog commit-a; roditelji pre dece
+    std::vector<git_oid> order;
+    walkCommits(repo->_repo, collectTips(branches), {*commit},
+                GIT_SORT_TOPOLOGICAL | GIT_SORT_REVERSE, order);
+
+    OidSet region;
+    region.reserve(order.size());
+    for (const git_oid& oid : order) {
+        region.insert(&oid);
+    }
+    region.normalize();
+
+    std::vector<char> containing(region.size(), 0);
+    for (const git_oid& oid : order) {
+        git_commit* current = nullptr;
+        if (git_commit_lookup(&current, repo->_repo, &oid) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+
+        bool found = false;
+        for (unsigned int i = 0; !found && i < git_commit_parentcount(current); ++i) {
+            const git_oid* parent = git_commit_parent_id(current, i);
+            size_t index;
+            found = git_oid_equal(parent, commit) ||
+                    (region.find(parent->id, &index) && containing[index]);
+        }
+        git_commit_free(current);
+
+        size_t index;
+        if (found && region.find(oid.id, &index)) {
+            containing[index] = 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<Branch>> result;
+    for (auto& branch : branches) {
+        const git_oid* tip = git_commit_id(branch->getLastCommit()->_commit);
+        size_t index;
+        if (git_oid_equal(tip, commit) || (region.find(tip->id, &index) && containing[index])) {
+            result.push_back(std::move(branch));
+        }
+    }
+    return result;
+}
+
+git::OidSet git::BranchGraph::getBranchTips(const std::vector<std::unique_ptr<Branch>>& branches) {
+    OidSet tips;
+    for (const auto& branch : branches) {
+        tips.insert(git_commit_id(branch->getLastCommit()->_commit));
+    }
+    tips.normalize();
+    return tips;
+}
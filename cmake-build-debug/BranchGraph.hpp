@@ -0,0 +1,36 @@
+#ifndef PROBA_BRANCHGRAPH_HPP
+#define PROBA_BRANCHGRAPH_HPP
+
+#include <git2.h>
+
+#include "OidSet.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class Repository;
+
+// upiti nad grafom commit-a svih grana; skupovi commit-a su OidSet, ne std::set<std::string>
+class BranchGraph {
+public:
+    // commit-i dostupni iz tips, bez onih dostupnih iz hidden
+    static OidSet getReachableCommits(Repository* repo, const std::vector<git_oid>& tips,
+                                      const std::vector<git_oid>& hidden = {});
+
+    // grane ciji je vrh vec sadrzan u target grani
+    static std::vector<std::unique_ptr<Branch>> getMergedBranches(Repository* repo,
+                                                                  const Branch* target);
+
+    // grane iz kojih je commit dostupan
+    static std::vector<std::unique_ptr<Branch>> getBranchesContaining(Repository* repo,
+                                                                      const git_oid* commit);
+
+    static OidSet getBranchTips(const std::vector<std::unique_ptr<Branch>>& branches);
+};
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include "BranchProtocol.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// false ako je veza zatvorena pre prvog bajta
+bool readAll(int fd, void* data, size_t size) {
+    char* p     = static_cast<char*>(data);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t count = ::read(fd, p + done, size - done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            throw std::runtime_error("Socket read failed: " + std::string(std::strerror(errno)));
+        }
+        if (count == 0) {
+            if (done == 0) {
+                return false;
+            }
+            throw std::runtime_error("Connection closed in the middle of a message.");
+        }
+        done += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+void writeAll(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size) {
+        ssize_t count = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error("Socket write failed: " + std::string(std::strerror(errno)));
+        }
+        p += count;
+        size -= static_cast<size_t>(count);
+    }
+}
+
+}
+
+void git::BranchMessage::putU8(uint8_t value) {
+    _data.push_back(static_cast<char>(value));
+}
+
+void git::BranchMessage::putU32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        _data.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void git::BranchMessage::putU64(uint64_t value) {
+    putU32(static_cast<uint32_t>(value));
+    putU32(static_cast<uint32_t>(value >> 32));
+}
+
+void git::BranchMessage::putString(const std::string& value) {
+    putU32(static_cast<uint32_t>(value.size()));
+    _data.append(value);
+}
+
+void git::BranchMessage::putOid(const git_oid& oid) {
+    _data.append(reinterpret_cast<const char*>(oid.id), sizeof(oid.id));
+}
+
+void git::BranchMessage::need(size_t size) const {
+    if (_data.size() - _position < size) {
+        throw std::runtime_error("Truncated branch protocol message.");
+    }
+}
+
+uint8_t git::BranchMessage::getU8() {
+    need(1);
+    return static_cast<uint8_t>(_data[_position++]);
+}
+
+uint32_t git::BranchMessage::getU32() {
+    need(4);
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(_data[_position++])) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t git::BranchMessage::getU64() {
+    uint64_t low = getU32();
+    return low | (static_cast<uint64_t>(getU32()) << 32);
+}
+
+std::string git::BranchMessage::getString() {
+    uint32_t size = getU32();
+    need(size);
+    std::string value = _data.substr(_position, size);
+    _position += size;
+    return value;
+}
+
+git_oid git::BranchMessage::getOid() {
+    git_oid oid;
+    need(sizeof(oid.id));
+    std::memcpy(oid.id, _data.data() + _position, sizeof(oid.id));
+    _position += sizeof(oid.id);
+    return oid;
+}
+
+bool git::BranchMessage::atEnd() const {
+    return _position == _data.size();
+}
+
+const std::string& git::BranchMessage::getData() const {
+    return _data;
+}
+
+void git::BranchMessage::reset(std::string data) {
+    _data     = std::move(data);
+    _position = 0;
+}
+
+bool git::BranchMessage::receive(int fd, BranchMessage* message) {
+    unsigned char header[4];
+    if (!readAll(fd, header, sizeof(header))) {
+        return false;
+    }
+
+    uint32_t size = header[0] | (header[1] << 8) | (header[2] << 16) |
+                    (static_cast<uint32_t>(header[3]) << 24);
+    if (size > kMaxSize) {
+        throw std::runtime_error("Branch protocol message is too large.");
+    }
+
+    std::string data(size, '\0');
+    if (size && !readAll(fd, &data[0], size)) {
+        throw std::runtime_error("Connection closed in the middle of a message.");
+    }
+    message->reset(std::move(data));
+    return true;
+}
+
+void git::BranchMessage::send(int fd, const BranchMessage& message) {
+    // duzina i telo jednim sistemskim pozivom
+    BranchMessage framed;
+    framed.putU32(static_cast<uint32_t>(message._data.size()));
+    framed._data.append(message._data);
+    writeAll(fd, framed._data.data(), framed._data.size());
+}
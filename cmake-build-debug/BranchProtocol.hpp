@@ -0,0 +1,60 @@
+#ifndef PROBA_BRANCHPROTOCOL_HPP
+#define PROBA_BRANCHPROTOCOL_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace git {
+
+// binarni protokol izmedju BranchDaemon-a i BranchClient-a: svaka poruka je
+// u32 duzina (little-endian) pa telo; zahtev pocinje opkodom, odgovor statusom
+enum class BranchOpcode : uint8_t {
+    ListBranches = 1,
+    GetTip       = 2,
+    AheadBehind  = 3,
+    Mergeability = 4,
+    Refresh      = 5,
+};
+
+enum class BranchStatus : uint8_t { Ok = 0, NotFound = 1, Error = 2 };
+
+enum class Mergeability : uint8_t { UpToDate = 0, FastForward = 1, Clean = 2, Conflicts = 3 };
+
+class BranchMessage {
+public:
+    static constexpr size_t kMaxSize = 64 * 1024 * 1024;
+
+    void putU8(uint8_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putString(const std::string& value);
+    void putOid(const git_oid& oid);
+
+    // citanje preko kraja poruke baca std::runtime_error
+    uint8_t getU8();
+    uint32_t getU32();
+    uint64_t getU64();
+    std::string getString();
+    git_oid getOid();
+
+    bool atEnd() const;
+    const std::string& getData() const;
+    void reset(std::string data);
+
+    // false kada je druga strana zatvorila vezu pre pocetka poruke
+    static bool receive(int fd, BranchMessage* message);
+    static void send(int fd, const BranchMessage& message);
+
+private:
+    void need(size_t size) const;
+
+    std::string _data;
+    size_t _position = 0;
+};
+
+}
+
+#endif
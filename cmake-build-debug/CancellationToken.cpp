@@ -0,0 +1,105 @@
+#include "CancellationToken.hpp"
+
+namespace {
+
+thread_local const git::CancellationScope* currentScope = nullptr;
+
+int64_t toTicks(git::CancellationToken::Clock::time_point point) {
+    return static_cast<int64_t>(point.time_since_epoch().count());
+}
+
+}
+
+git::OperationCancelled::OperationCancelled() : std::runtime_error("Operation was cancelled.") {}
+
+git::OperationCancelled::OperationCancelled(const std::string& message)
+    : std::runtime_error(message) {}
+
+git::DeadlineExceeded::DeadlineExceeded() : OperationCancelled("Operation deadline exceeded.") {}
+
+git::CancellationToken::CancellationToken() : _state(std::make_shared<State>()) {}
+
+void git::CancellationToken::cancel() {
+    _state->cancelled.store(true);
+}
+
+bool git::CancellationToken::isExpired() const {
+    int64_t deadline = _state->deadline.load();
+    return deadline != INT64_MAX && toTicks(Clock::now()) >= deadline;
+}
+
+bool git::CancellationToken::isCancelled() const {
+    return _state->cancelled.load() || isExpired();
+}
+
+void git::CancellationToken::setDeadline(Clock::time_point deadline) {
+    int64_t ticks   = toTicks(deadline);
+    int64_t current = _state->deadline.load();
+    while (ticks < current && !_state->deadline.compare_exchange_weak(current, ticks)) {
+    }
+}
+
+void git::CancellationToken::setTimeout(Clock::duration timeout) {
+    setDeadline(Clock::now() + timeout);
+}
+
+bool git::CancellationToken::hasDeadline() const {
+    return _state->deadline.load() != INT64_MAX;
+}
+
+git::CancellationToken::Clock::time_point git::CancellationToken::getDeadline() const {
+    return Clock::time_point(Clock::duration(_state->deadline.load()));
+}
+
+void git::CancellationToken::check() const {
+    if (_state->cancelled.load()) {
+        throw OperationCancelled();
+    }
+    if (isExpired()) {
+        throw DeadlineExceeded();
+    }
+}
+
+git::CancellationScope::CancellationScope(CancellationToken token)
+    : _token(token), _previous(currentScope) {
+    currentScope = this;
+}
+
+git::CancellationScope::~CancellationScope() {
+    currentScope = _previous;
+}
+
+bool git::CancellationScope::isCancelled() {
+    // spoljni opseg (npr. rok celog zahteva) vazi i unutar ugnezdenog
+    for (const CancellationScope* scope = currentScope; scope; scope = scope->_previous) {
+        if (scope->_token.isCancelled()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void git::CancellationScope::check() {
+    for (const CancellationScope* scope = currentScope; scope; scope = scope->_previous) {
+        scope->_token.check();
+    }
+}
+
+void git::CancellationScope::apply(git_checkout_options* options) {
+    if (!currentScope) {
+        return;
+    }
+    options->notify_flags |= GIT_CHECKOUT_NOTIFY_ALL;
+    options->notify_cb = &CancellationScope::notify;
+}
+
+int git::CancellationScope::notify(git_checkout_notify_t, const char*, const git_diff_file*,
+                                   const git_diff_file*, const git_diff_file*, void*) {
+    return isCancelled() ? GIT_EUSER : 0;
+}
+
+void git::CancellationScope::rethrowIfCancelled(int error) {
+    if (error == GIT_EUSER) {
+        check();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef PROBA_CANCELLATIONTOKEN_HPP
+#define PROBA_CANCELLATIONTOKEN_HPP
+
+#include <git2.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace git {
+
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled();
+
+protected:
+    explicit OperationCancelled(const std::string& message);
+};
+
+class DeadlineExceeded : public OperationCancelled {
+public:
+    DeadlineExceeded();
+};
+
+// deljeni znak za otkazivanje; kopije dele isto stanje, ukljucujuci rok
+class CancellationToken {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    CancellationToken();
+
+    void cancel();
+    bool isCancelled() const;
+
+    // posle roka se token ponasa kao otkazan; raniji rok zamenjuje kasniji, ne obrnuto
+    void setDeadline(Clock::time_point deadline);
+    void setTimeout(Clock::duration timeout);
+    bool hasDeadline() const;
+    Clock::time_point getDeadline() const;
+
+    // baca OperationCancelled (DeadlineExceeded ako je istekao rok) ako je otkazano
+    void check() const;
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::atomic<int64_t> deadline{INT64_MAX};
+    };
+
+    bool isExpired() const;
+
+    std::shared_ptr<State> _state;
+};
+
+// token tekuce niti: Branch operacije i libgit2 povratni pozivi ga proveravaju, pa se
+// otkazivanje ne mora provlaciti kroz svaki potpis; opsezi se mogu ugnezdavati
+class CancellationScope {
+public:
+    explicit CancellationScope(CancellationToken token);
+    ~CancellationScope();
+
+    CancellationScope(const CancellationScope&)            = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+    static bool isCancelled();
+    static void check();
+
+    // notify povratni poziv prekida checkout pre upisa prvog fajla, pa radni
+    // direktorijum ostaje netaknut
+    static void apply(git_checkout_options* options);
+
+    // posle libgit2 greske: ako je uzrok otkazivanje, baca OperationCancelled
+    static void rethrowIfCancelled(int error);
+
+private:
+    static int notify(git_checkout_notify_t why, const char* path, const git_diff_file* baseline,
+                      const git_diff_file* target, const git_diff_file* workdir, void* payload);
+
+    CancellationToken _token;
+    const CancellationScope* _previous;
+};
+
+}
+
+#endif
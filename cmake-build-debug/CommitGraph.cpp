@@ -0,0 +1,245 @@
+#include "CommitGraph.hpp"
+
+#include "Branch.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t kChunkFanout      = 0x4f494446;  // "OIDF"
+const uint32_t kChunkLookup      = 0x4f49444c;  // "OIDL"
+const uint32_t kChunkData        = 0x43444154;  // "CDAT"
+const uint32_t kChunkEdges       = 0x45444745;  // "EDGE"
+const size_t kHeaderSize         = 8;
+const size_t kChunkEntrySize     = 12;
+const size_t kFanoutSize         = 256 * 4;
+const size_t kCommitDataSize     = git::CommitGraph::kHashSize + 16;
+const uint32_t kParentNone       = 0x70000000;
+const uint32_t kParentExtraEdges = 0x80000000;
+const uint32_t kLastEdge         = 0x80000000;
+
+uint32_t readBigEndian32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t readBigEndian64(const unsigned char* p) {
+    return (static_cast<uint64_t>(readBigEndian32(p)) << 32) | readBigEndian32(p + 4);
+}
+
+const unsigned char* mapFile(const std::string& path, size_t* size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    *size = static_cast<size_t>(st.st_size);
+    return static_cast<const unsigned char*>(data);
+}
+
+}
+
+git::CommitGraph::~CommitGraph() {
+    for (const Layer& layer : _layers) {
+        munmap(const_cast<unsigned char*>(layer.data), layer.size);
+    }
+}
+
+std::unique_ptr<git::CommitGraph> git::CommitGraph::open(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    return open(repo->_repo);
+}
+
+std::unique_ptr<git::CommitGraph> git::CommitGraph::open(git_repository* repo) {
+    std::string objects = std::string(git_repository_path(repo)) + "objects/info/";
+    std::unique_ptr<CommitGraph> graph(new CommitGraph());
+
+    // lanac ima prednost nad pojedinacnim fajlom, kao i u git-u; prvi red je osnovni sloj
+    std::ifstream chain(objects + "commit-graphs/commit-graph-chain");
+    if (chain) {
+        std::string hash;
+        while (std::getline(chain, hash)) {
+            if (hash.empty()) {
+                continue;
+            }
+            if (!graph->addLayer(objects + "commit-graphs/graph-" + hash + ".graph")) {
+                return nullptr;
+            }
+        }
+        if (!graph->_layers.empty()) {
+            return graph;
+        }
+    }
+
+    if (!graph->addLayer(objects + "commit-graph")) {
+        return nullptr;
+    }
+    return graph;
+}
+
+bool git::CommitGraph::addLayer(const std::string& path) {
+    Layer layer;
+    layer.data = mapFile(path, &layer.size);
+    if (!layer.data) {
+        return false;
+    }
+    layer.base = _layers.empty() ? 0 : _layers.back().base + _layers.back().count;
+    // mapiranje se oslobadja u destruktoru i kada sloj nije ispravan
+    _layers.push_back(layer);
+    Layer& added = _layers.back();
+
+    const unsigned char* data = added.data;
+    // samo SHA-1 graf (verzija heša 1); za ostale se vraca na parsiranje objekata
+    if (added.size < kHeaderSize || readBigEndian32(data) != kSignature || data[4] != 1 ||
+        data[5] != 1) {
+        return false;
+    }
+
+    size_t chunks = data[6];
+    if (kHeaderSize + (chunks + 1) * kChunkEntrySize > added.size) {
+        return false;
+    }
+    uint64_t lookupSize = 0;
+    uint64_t dataSize   = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        const unsigned char* entry = data + kHeaderSize + i * kChunkEntrySize;
+        uint32_t id                = readBigEndian32(entry);
+        uint64_t offset            = readBigEndian64(entry + 4);
+        uint64_t end               = readBigEndian64(entry + 4 + kChunkEntrySize);
+        if (offset > end || end > added.size) {
+            return false;
+        }
+        if (id == kChunkFanout && end - offset >= kFanoutSize) {
+            added.fanout = data + offset;
+        } else if (id == kChunkLookup) {
+            added.oids = data + offset;
+            lookupSize = end - offset;
+        } else if (id == kChunkData) {
+            added.commitData = data + offset;
+            dataSize         = end - offset;
+        } else if (id == kChunkEdges) {
+            added.edges     = data + offset;
+            added.edgeCount = static_cast<size_t>(end - offset) / 4;
+        }
+    }
+    if (!added.fanout || !added.oids || !added.commitData) {
+        return false;
+    }
+
+    added.count = readBigEndian32(added.fanout + 255 * 4);
+    return lookupSize >= static_cast<uint64_t>(added.count) * kHashSize &&
+           dataSize >= static_cast<uint64_t>(added.count) * kCommitDataSize;
+}
+
+const git::CommitGraph::Layer& git::CommitGraph::layerOf(uint32_t position) const {
+    for (size_t i = _layers.size(); i-- > 0;) {
+        if (position >= _layers[i].base) {
+            return _layers[i];
+        }
+    }
+    return _layers.front();
+}
+
+const unsigned char* git::CommitGraph::commitData(uint32_t position) const {
+    const Layer& layer = layerOf(position);
+    return layer.commitData + static_cast<size_t>(position - layer.base) * kCommitDataSize;
+}
+
+bool git::CommitGraph::find(const git_oid* oid, uint32_t* position) const {
+    // noviji slojevi prvo; commit je u tacno jednom sloju
+    for (size_t i = _layers.size(); i-- > 0;) {
+        const Layer& layer = _layers[i];
+        unsigned char first = oid->id[0];
+        uint32_t low        = first == 0 ? 0 : readBigEndian32(layer.fanout + (first - 1) * 4);
+        uint32_t high       = readBigEndian32(layer.fanout + first * 4);
+        while (low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            int compare = std::memcmp(layer.oids + static_cast<size_t>(middle) * kHashSize,
+                                      oid->id, kHashSize);
+            if (compare == 0) {
+                *position = layer.base + middle;
+                return true;
+            }
+            if (compare < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+    }
+    return false;
+}
+
+uint32_t git::CommitGraph::size() const {
+    return _layers.back().base + _layers.back().count;
+}
+
+git_oid git::CommitGraph::getId(uint32_t position) const {
+    const Layer& layer = layerOf(position);
+    git_oid oid;
+    std::memcpy(oid.id, layer.oids + static_cast<size_t>(position - layer.base) * kHashSize,
+                kHashSize);
+    return oid;
+}
+
+uint32_t git::CommitGraph::getGeneration(uint32_t position) const {
+    // gornjih 30 bita: topoloski nivo, koji i graf verzije 2 cuva u CDAT-u
+    return readBigEndian32(commitData(position) + kHashSize + 8) >> 2;
+}
+
+int64_t git::CommitGraph::getCommitTime(uint32_t position) const {
+    const unsigned char* data = commitData(position) + kHashSize + 8;
+    return static_cast<int64_t>((static_cast<uint64_t>(readBigEndian32(data) & 3) << 32) |
+                                readBigEndian32(data + 4));
+}
+
+void git::CommitGraph::getParents(uint32_t position, std::vector<uint32_t>& parents) const {
+    parents.clear();
+    const Layer& layer        = layerOf(position);
+    const unsigned char* data = commitData(position) + kHashSize;
+
+    uint32_t first = readBigEndian32(data);
+    if (first == kParentNone) {
+        return;
+    }
+    parents.push_back(first);
+
+    uint32_t second = readBigEndian32(data + 4);
+    if (second == kParentNone) {
+        return;
+    }
+    if (!(second & kParentExtraEdges)) {
+        parents.push_back(second);
+        return;
+    }
+
+    // octopus: ostali roditelji su u EDGE listi, poslednji ima postavljen gornji bit
+    for (size_t edge = second & ~kParentExtraEdges; edge < layer.edgeCount; ++edge) {
+        uint32_t value = readBigEndian32(layer.edges + edge * 4);
+        parents.push_back(value & ~kLastEdge);
+        if (value & kLastEdge) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PROBA_COMMITGRAPH_HPP
+#define PROBA_COMMITGRAPH_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// citac git commit-graph fajla (objects/info/commit-graph ili lanac u
+// objects/info/commit-graphs/) preko mmap-a: roditelji, vreme i generacija
+// (topoloski nivo) commit-a bez parsiranja objekata; pozicije su globalne kroz lanac
+class CommitGraph {
+public:
+    static constexpr uint32_t kSignature          = 0x43475048;  // "CGPH"
+    static constexpr uint32_t kGenerationInfinity = 0xffffffff;
+    static constexpr size_t kHashSize             = 20;
+
+    CommitGraph(const CommitGraph&)            = delete;
+    CommitGraph& operator=(const CommitGraph&) = delete;
+    ~CommitGraph();
+
+    // nullptr ako repozitorijum nema (ispravan) commit-graph
+    static std::unique_ptr<CommitGraph> open(Repository* repo);
+    static std::unique_ptr<CommitGraph> open(git_repository* repo);
+
+    bool find(const git_oid* oid, uint32_t* position) const;
+
+    uint32_t size() const;
+    git_oid getId(uint32_t position) const;
+    uint32_t getGeneration(uint32_t position) const;
+    int64_t getCommitTime(uint32_t position) const;
+    void getParents(uint32_t position, std::vector<uint32_t>& parents) const;
+
+private:
+    struct Layer {
+        const unsigned char* data = nullptr;
+        size_t size               = 0;
+        uint32_t count            = 0;
+        uint32_t base             = 0;  // broj commit-a u nizim slojevima
+        const unsigned char* fanout     = nullptr;
+        const unsigned char* oids       = nullptr;
+        const unsigned char* commitData = nullptr;
+        const unsigned char* edges      = nullptr;
+        size_t edgeCount                = 0;
+    };
+
+    CommitGraph() = default;
+
+    bool addLayer(const std::string& path);
+    const Layer& layerOf(uint32_t position) const;
+    const unsigned char* commitData(uint32_t position) const;
+
+    std::vector<Layer> _layers;
+};
+
+}
+
+#endif
@@ -0,0 +1,462 @@
+#include "CommitIndex.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+const char kMagic[4] = {'P', 'C', 'I', 'X'};
+
+std::string toLower(const char* data, size_t size) {
+    std::string lower(data, size);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+uint32_t trigram(const char* p) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
+
+template <typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void writeVector(std::ostream& out, const std::vector<T>& values) {
+    writePod(out, static_cast<uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+void writeString(std::ostream& out, const std::string& value) {
+    writePod(out, static_cast<uint64_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+bool readPod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template <typename T>
+bool readVector(std::istream& in, std::vector<T>& values) {
+    uint64_t size = 0;
+    if (!readPod(in, size)) {
+        return false;
+    }
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+                                     static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+bool readString(std::istream& in, std::string& value) {
+    uint64_t size = 0;
+    if (!readPod(in, size)) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(&value[0], static_cast<std::streamsize>(size)));
+}
+
+}
+
+size_t git::CommitIndex::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::CommitIndex::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+git::CommitIndex::CommitIndex(Repository* repo)
+    : _repo(repo), _messageOffsets(1, 0), _parentOffsets(1, 0) {}
+
+git::CommitIndex::~CommitIndex() = default;
+
+std::unique_ptr<git::CommitIndex> git::CommitIndex::create(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::unique_ptr<CommitIndex> index(new CommitIndex(repo));
+    // neispravan ili zastareo fajl se jednostavno gradi iznova
+    if (!index->load()) {
+        std::unique_ptr<CommitIndex> empty(new CommitIndex(repo));
+        return empty;
+    }
+    return index;
+}
+
+std::string git::CommitIndex::getPath() const {
+    return std::string(git_repository_path(_repo->_repo)) + kIndexFile;
+}
+
+size_t git::CommitIndex::size() const {
+    return _oids.size();
+}
+
+size_t git::CommitIndex::update() {
+    auto branches = Branch::getAllBranches(_repo);
+
+    git_revwalk* walk = nullptr;
+    if (git_revwalk_new(&walk, _repo->_repo) != 0) {
+        throw std::runtime_error("Failed to create revision walker: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    // roditelji pre dece, da bi kolona roditelja uvek pokazivala unazad
+    int error = git_revwalk_sorting(walk, GIT_SORT_TOPOLOGICAL | GIT_SORT_REVERSE);
+    std::vector<git_oid> tips;
+    for (size_t i = 0; error == 0 && i < branches.size(); ++i) {
+        tips.push_back(*git_commit_id(branches[i]->getLastCommit()->_commit));
+        error = git_revwalk_push(walk, &tips.back());
+    }
+    for (size_t i = 0; error == 0 && i < _tips.size(); ++i) {
+        // prethodni vrh moze biti nedostupan posle gc-a; tada se samo ne skriva
+        if (_positions.count(_tips[i])) {
+            git_commit* commit = nullptr;
+            if (git_commit_lookup(&commit, _repo->_repo, &_tips[i]) == 0) {
+                git_commit_free(commit);
+                error = git_revwalk_hide(walk, &_tips[i]);
+            }
+        }
+    }
+
+    std::vector<git_oid> commits;
+    git_oid oid;
+    while (error == 0 && (error = git_revwalk_next(&oid, walk)) == 0) {
+        if (!_positions.count(oid)) {
+            commits.push_back(oid);
+        }
+    }
+    git_revwalk_free(walk);
+    if (error != GIT_ITEROVER) {
+        throw std::runtime_error("Revision walk failed: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    for (const git_oid& id : commits) {
+        git_commit* commit = nullptr;
+        if (git_commit_lookup(&commit, _repo->_repo, &id) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+        append(commit);
+        git_commit_free(commit);
+    }
+
+    _tips = tips;
+    save();
+    return commits.size();
+}
+
+void git::CommitIndex::append(git_commit* commit) {
+    uint32_t position = static_cast<uint32_t>(_oids.size());
+    const git_oid* id = git_commit_id(commit);
+    _oids.push_back(*id);
+    _positions[*id] = position;
+
+    const git_signature* author = git_commit_author(commit);
+    _times.push_back(author->when.time);
+
+    std::string name = std::string(author->name) + " <" + author->email + ">";
+    auto found       = _authorIds.find(name);
+    if (found == _authorIds.end()) {
+        found = _authorIds.emplace(name, static_cast<uint32_t>(_authorNames.size())).first;
+        _authorNames.push_back(name);
+    }
+    _authors.push_back(found->second);
+
+    for (unsigned int i = 0; i < git_commit_parentcount(commit); ++i) {
+        auto parent = _positions.find(*git_commit_parent_id(commit, i));
+        _parents.push_back(parent != _positions.end() ? parent->second : kNone);
+    }
+    _parentOffsets.push_back(static_cast<uint32_t>(_parents.size()));
+
+    const char* message = git_commit_message(commit);
+    message             = message ? message : "";
+    _messages.append(message);
+    _messageOffsets.push_back(_messages.size());
+
+    std::string lower = toLower(message, std::strlen(message));
+    std::unordered_set<uint32_t> seen;
+    for (size_t i = 0; i + 3 <= lower.size(); ++i) {
+        uint32_t key = trigram(lower.data() + i);
+        if (seen.insert(key).second) {
+            _trigrams[key].push_back(position);
+        }
+    }
+}
+
+std::vector<git::CommitIndex::Match> git::CommitIndex::search(const Query& query) const {
+    std::vector<uint32_t> candidates;
+    if (query.message.size() >= 3) {
+        candidates = findMessageCandidates(toLower(query.message.data(), query.message.size()));
+    } else {
+        candidates.resize(_oids.size());
+        for (uint32_t i = 0; i < candidates.size(); ++i) {
+            candidates[i] = i;
+        }
+    }
+
+    // autora ima malo, pa se uslov proverava nad recnikom, a kolona poredi po id-u
+    std::vector<char> authorMatches;
+    if (!query.author.empty()) {
+        std::string needle = toLower(query.author.data(), query.author.size());
+        authorMatches.resize(_authorNames.size(), 0);
+        for (size_t i = 0; i < _authorNames.size(); ++i) {
+            const std::string& name = _authorNames[i];
+            authorMatches[i] = toLower(name.data(), name.size()).find(needle) != std::string::npos;
+        }
+    }
+
+    std::string messageNeedle = toLower(query.message.data(), query.message.size());
+    std::vector<uint32_t> matches;
+    for (uint32_t i : candidates) {
+        if (_times[i] < query.since || _times[i] > query.until) {
+            continue;
+        }
+        if (!authorMatches.empty() && !authorMatches[_authors[i]]) {
+            continue;
+        }
+        if (!messageNeedle.empty()) {
+            const char* message = _messages.data() + _messageOffsets[i];
+            size_t length       = _messageOffsets[i + 1] - _messageOffsets[i];
+            if (toLower(message, length).find(messageNeedle) == std::string::npos) {
+                continue;
+            }
+        }
+        matches.push_back(i);
+    }
+
+    std::stable_sort(matches.begin(), matches.end(),
+                     [this](uint32_t a, uint32_t b) { return _times[a] > _times[b]; });
+
+    std::vector<std::vector<std::string>> branches = findBranches(matches);
+    std::vector<Match> result;
+    for (size_t m = 0; m < matches.size(); ++m) {
+        if (query.limit && result.size() == query.limit) {
+            break;
+        }
+        if (branches[m].empty()) {
+            continue;
+        }
+
+        uint32_t i          = matches[m];
+        const char* message = _messages.data() + _messageOffsets[i];
+        size_t length       = _messageOffsets[i + 1] - _messageOffsets[i];
+        const char* eol     = static_cast<const char*>(std::memchr(message, '\n', length));
+
+        Match match;
+        match.commit   = _oids[i];
+        match.time     = _times[i];
+        match.author   = _authorNames[_authors[i]];
+        match.summary  = std::string(message, eol ? eol : message + length);
+        match.branches = std::move(branches[m]);
+        result.push_back(std::move(match));
+    }
+    return result;
+}
+
+std::vector<uint32_t> git::CommitIndex::findMessageCandidates(const std::string& needle) const {
+    // presek posting lista, od najkrace
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+        auto found = _trigrams.find(trigram(needle.data() + i));
+        if (found == _trigrams.end()) {
+            return {};
+        }
+        lists.push_back(&found->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+                  return a->size() < b->size();
+              });
+
+    std::vector<uint32_t> result = *lists.front();
+    std::vector<uint32_t> next;
+    for (size_t l = 1; l < lists.size() && !result.empty(); ++l) {
+        next.clear();
+        std::set_intersection(result.begin(), result.end(), lists[l]->begin(), lists[l]->end(),
+                              std::back_inserter(next));
+        result.swap(next);
+    }
+    return result;
+}
+
+std::vector<std::vector<std::string>> git::CommitIndex::findBranches(
+    const std::vector<uint32_t>& commits) const {
+    std::vector<std::vector<std::string>> result(commits.size());
+    if (commits.empty()) {
+        return result;
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> tips;
+    for (const auto& branch : Branch::getAllBranches(_repo)) {
+        auto found = _positions.find(*git_commit_id(branch->getLastCommit()->_commit));
+        if (found != _positions.end()) {
+            tips.emplace_back(found->second, branch->getBranchName());
+        }
+    }
+
+    // mnogo rezultata: dostupnost se racuna od svakog vrha nanize kroz kolonu roditelja
+    if (commits.size() / 64 > tips.size()) {
+        std::vector<char> reachable;
+        std::vector<uint32_t> stack;
+        for (const auto& tip : tips) {
+            reachable.assign(_oids.size(), 0);
+            stack.assign(1, tip.first);
+            reachable[tip.first] = 1;
+            while (!stack.empty()) {
+                uint32_t i = stack.back();
+                stack.pop_back();
+                for (uint32_t p = _parentOffsets[i]; p < _parentOffsets[i + 1]; ++p) {
+                    if (_parents[p] != kNone && !reachable[_parents[p]]) {
+                        reachable[_parents[p]] = 1;
+                        stack.push_back(_parents[p]);
+                    }
+                }
+            }
+            for (size_t c = 0; c < commits.size(); ++c) {
+                if (reachable[commits[c]]) {
+                    result[c].push_back(tip.second);
+                }
+            }
+        }
+        return result;
+    }
+
+    // inace po 64 rezultata: bit se prenosi od commit-a na decu, pa maska vrha grane kaze koje
+    // rezultate grana sadrzi
+    std::vector<uint64_t> masks;
+    for (size_t batch = 0; batch < commits.size(); batch += 64) {
+        size_t count   = std::min<size_t>(64, commits.size() - batch);
+        uint32_t start = *std::min_element(commits.begin() + batch,
+                                           commits.begin() + batch + count);
+
+        masks.assign(_oids.size() - start, 0);
+        for (size_t b = 0; b < count; ++b) {
+            masks[commits[batch + b] - start] |= uint64_t(1) << b;
+        }
+        for (uint32_t i = start; i < _oids.size(); ++i) {
+            uint64_t mask = masks[i - start];
+            for (uint32_t p = _parentOffsets[i]; p < _parentOffsets[i + 1]; ++p) {
+                if (_parents[p] != kNone && _parents[p] >= start) {
+                    mask |= masks[_parents[p] - start];
+                }
+            }
+            masks[i - start] = mask;
+        }
+
+        for (const auto& tip : tips) {
+            if (tip.first < start) {
+                continue;
+            }
+            uint64_t mask = masks[tip.first - start];
+            for (size_t b = 0; b < count; ++b) {
+                if (mask & (uint64_t(1) << b)) {
+                    result[batch + b].push_back(tip.second);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool git::CommitIndex::load() {
+    std::ifstream in(getPath(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t oidSize = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+        !readPod(in, version) || version != kVersion || !readPod(in, oidSize) ||
+        oidSize != sizeof(git_oid)) {
+        return false;
+    }
+
+    uint64_t authorCount = 0;
+    bool ok = readVector(in, _oids) && readVector(in, _times) && readVector(in, _authors) &&
+              readVector(in, _messageOffsets) && readVector(in, _parentOffsets) &&
+              readVector(in, _parents) && readString(in, _messages) && readVector(in, _tips) &&
+              readPod(in, authorCount);
+    for (uint64_t i = 0; ok && i < authorCount; ++i) {
+        _authorNames.emplace_back();
+        ok = readString(in, _authorNames.back());
+    }
+
+    uint64_t trigramCount = 0;
+    ok = ok && readPod(in, trigramCount);
+    for (uint64_t i = 0; ok && i < trigramCount; ++i) {
+        uint32_t key = 0;
+        ok           = readPod(in, key) && readVector(in, _trigrams[key]);
+    }
+
+    size_t count = _oids.size();
+    if (!ok || _times.size() != count || _authors.size() != count ||
+        _messageOffsets.size() != count + 1 || _parentOffsets.size() != count + 1) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        _positions[_oids[i]] = i;
+    }
+    for (uint32_t i = 0; i < _authorNames.size(); ++i) {
+        _authorIds[_authorNames[i]] = i;
+    }
+    return true;
+}
+
+void git::CommitIndex::save() const {
+    std::string path      = getPath();
+    std::string temporary = path + ".lock";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(kMagic, sizeof(kMagic));
+        writePod(out, kVersion);
+        writePod(out, static_cast<uint64_t>(sizeof(git_oid)));
+
+        writeVector(out, _oids);
+        writeVector(out, _times);
+        writeVector(out, _authors);
+        writeVector(out, _messageOffsets);
+        writeVector(out, _parentOffsets);
+        writeVector(out, _parents);
+        writeString(out, _messages);
+        writeVector(out, _tips);
+
+        writePod(out, static_cast<uint64_t>(_authorNames.size()));
+        for (const std::string& name : _authorNames) {
+            writeString(out, name);
+        }
+        writePod(out, static_cast<uint64_t>(_trigrams.size()));
+        for (const auto& entry : _trigrams) {
+            writePod(out, entry.first);
+            writeVector(out, entry.second);
+        }
+
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + temporary + " to " + path);
+    }
+}
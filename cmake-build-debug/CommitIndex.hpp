@@ -0,0 +1,99 @@
+#ifndef PROBA_COMMITINDEX_HPP
+#define PROBA_COMMITINDEX_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// trajni indeks metapodataka commit-a svih grana: autor i vreme kao kolone, poruke preko
+// trigrama; commit-i su u topoloskom redosledu (roditelji pre dece), pa se grane koje
+// sadrze rezultat racunaju jednim prolazom kroz kolonu roditelja, bez setnje istorije
+class CommitIndex {
+public:
+    static constexpr const char* kIndexFile = "proba-commit-index";
+    static constexpr uint32_t kVersion      = 1;
+    static constexpr uint32_t kNone         = std::numeric_limits<uint32_t>::max();
+
+    struct Query {
+        // podnizovi, bez obzira na velika i mala slova; prazan uslov se ne proverava
+        std::string author;
+        std::string message;
+        int64_t since = std::numeric_limits<int64_t>::min();
+        int64_t until = std::numeric_limits<int64_t>::max();
+        size_t limit  = 0;
+    };
+
+    struct Match {
+        git_oid commit;
+        int64_t time;
+        std::string author;
+        std::string summary;
+        std::vector<std::string> branches;
+    };
+
+    CommitIndex(const CommitIndex&)            = delete;
+    CommitIndex& operator=(const CommitIndex&) = delete;
+    ~CommitIndex();
+
+    // ucitava postojeci indeks ako postoji; bez update() ne vidi nove commit-e
+    static std::unique_ptr<CommitIndex> create(Repository* repo);
+
+    // dodaje commit-e dostupne iz trenutnih vrhova grana, a nedostupne iz prethodnih,
+    // i cuva indeks; vraca broj dodatih commit-a
+    size_t update();
+
+    // najnoviji rezultati prvi; commit-i koje vise ne sadrzi nijedna grana se izostavljaju
+    std::vector<Match> search(const Query& query) const;
+
+    size_t size() const;
+    std::string getPath() const;
+
+private:
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+
+    explicit CommitIndex(Repository* repo);
+
+    bool load();
+    void save() const;
+    void append(git_commit* commit);
+
+    std::vector<uint32_t> findMessageCandidates(const std::string& needle) const;
+    std::vector<std::vector<std::string>> findBranches(const std::vector<uint32_t>& commits) const;
+
+    Repository* _repo;
+
+    // kolone, po jedan element po commit-u
+    std::vector<git_oid> _oids;
+    std::vector<int64_t> _times;
+    std::vector<uint32_t> _authors;
+    std::vector<uint64_t> _messageOffsets;
+    std::vector<uint32_t> _parentOffsets;
+
+    std::vector<std::string> _authorNames;
+    std::string _messages;
+    std::vector<uint32_t> _parents;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> _trigrams;
+    std::vector<git_oid> _tips;
+
+    std::unordered_map<git_oid, uint32_t, OidHash, OidEqual> _positions;
+    std::unordered_map<std::string, uint32_t> _authorIds;
+};
+
+}
+
+#endif
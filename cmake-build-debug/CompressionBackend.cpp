@@ -0,0 +1,193 @@
+#include "CompressionBackend.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#ifdef GIT_USE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+namespace {
+
+const size_t kMinBuffer = 4096;
+
+void inflateInto(const unsigned char* data, size_t size, size_t sizeHint, size_t limit,
+                 std::string& out) {
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) {
+        throw std::runtime_error("Failed to initialize zlib inflate.");
+    }
+
+    stream.next_in  = const_cast<Bytef*>(data);
+    stream.avail_in = static_cast<uInt>(size);
+
+    size_t capacity = sizeHint ? sizeHint + 1 : std::max(size * 4, kMinBuffer);
+    if (limit) {
+        capacity = std::min(capacity, limit);
+    }
+    out.resize(capacity);
+
+    int result = Z_OK;
+    while (true) {
+        if (stream.total_out == out.size()) {
+            if (limit && out.size() >= limit) {
+                break;
+            }
+            size_t grown = out.size() * 2;
+            out.resize(limit ? std::min(grown, limit) : grown);
+        }
+
+        stream.next_out  = reinterpret_cast<Bytef*>(&out[stream.total_out]);
+        stream.avail_out = static_cast<uInt>(out.size() - stream.total_out);
+
+        result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            break;
+        }
+        if (result != Z_OK && !(result == Z_BUF_ERROR && stream.avail_out == 0)) {
+            inflateEnd(&stream);
+            throw std::runtime_error("Corrupt zlib stream.");
+        }
+    }
+
+    out.resize(stream.total_out);
+    inflateEnd(&stream);
+}
+
+class ZlibBackend : public git::CompressionBackend {
+public:
+    const char* getName() const override {
+        return "zlib";
+    }
+
+    void compress(const unsigned char* data, size_t size, int level,
+                  std::string& out) const override {
+        z_stream stream = {};
+        if (deflateInit(&stream, level) != Z_OK) {
+            throw std::runtime_error("Failed to initialize zlib deflate.");
+        }
+
+        out.resize(deflateBound(&stream, static_cast<uLong>(size)));
+        stream.next_in   = const_cast<Bytef*>(data);
+        stream.avail_in  = static_cast<uInt>(size);
+        stream.next_out  = reinterpret_cast<Bytef*>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+
+        int result = deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END) {
+            throw std::runtime_error("zlib deflate failed.");
+        }
+    }
+
+    void decompress(const unsigned char* data, size_t size, size_t sizeHint,
+                    std::string& out) const override {
+        inflateInto(data, size, sizeHint, 0, out);
+    }
+};
+
+#ifdef GIT_USE_LIBDEFLATE
+// libdeflate kompresori nisu thread-safe, pa svaka nit ima svoje
+struct CompressorDeleter {
+    void operator()(libdeflate_compressor* compressor) const {
+        libdeflate_free_compressor(compressor);
+    }
+};
+
+struct DecompressorDeleter {
+    void operator()(libdeflate_decompressor* decompressor) const {
+        libdeflate_free_decompressor(decompressor);
+    }
+};
+
+class LibdeflateBackend : public git::CompressionBackend {
+public:
+    const char* getName() const override {
+        return "libdeflate";
+    }
+
+    void compress(const unsigned char* data, size_t size, int level,
+                  std::string& out) const override {
+        thread_local std::unique_ptr<libdeflate_compressor, CompressorDeleter> compressors[13];
+
+        level = std::max(0, std::min(level, 12));
+        auto& compressor = compressors[level];
+        if (!compressor) {
+            compressor.reset(libdeflate_alloc_compressor(level));
+            if (!compressor) {
+                throw std::runtime_error("Failed to allocate libdeflate compressor.");
+            }
+        }
+
+        out.resize(libdeflate_zlib_compress_bound(compressor.get(), size));
+        size_t written =
+            libdeflate_zlib_compress(compressor.get(), data, size, &out[0], out.size());
+        if (written == 0) {
+            throw std::runtime_error("libdeflate compression failed.");
+        }
+        out.resize(written);
+    }
+
+    void decompress(const unsigned char* data, size_t size, size_t sizeHint,
+                    std::string& out) const override {
+        thread_local std::unique_ptr<libdeflate_decompressor, DecompressorDeleter> decompressor;
+        if (!decompressor) {
+            decompressor.reset(libdeflate_alloc_decompressor());
+            if (!decompressor) {
+                throw std::runtime_error("Failed to allocate libdeflate decompressor.");
+            }
+        }
+
+        // libdeflate ne radi u delovima, pa bafer uvecavamo dok izlaz ne stane
+        out.resize(sizeHint ? sizeHint : std::max(size * 4, kMinBuffer));
+        while (true) {
+            size_t produced = 0;
+            libdeflate_result result = libdeflate_zlib_decompress(
+                decompressor.get(), data, size, &out[0], out.size(), &produced);
+            if (result == LIBDEFLATE_SUCCESS) {
+                out.resize(produced);
+                return;
+            }
+            if (result != LIBDEFLATE_INSUFFICIENT_SPACE) {
+                throw std::runtime_error("Corrupt zlib stream.");
+            }
+            out.resize(out.size() * 2);
+        }
+    }
+};
+#endif
+
+}
+
+void git::CompressionBackend::decompressPrefix(const unsigned char* data, size_t size,
+                                               size_t maxSize, std::string& out) const {
+    inflateInto(data, size, 0, maxSize, out);
+}
+
+std::unique_ptr<git::CompressionBackend> git::CompressionBackend::create(const std::string& name) {
+    if (name == "zlib") {
+        return std::unique_ptr<CompressionBackend>(new ZlibBackend());
+    }
+#ifdef GIT_USE_LIBDEFLATE
+    if (name == "libdeflate") {
+        return std::unique_ptr<CompressionBackend>(new LibdeflateBackend());
+    }
+#endif
+    throw std::invalid_argument("Unknown compression backend: " + name);
+}
+
+std::unique_ptr<git::CompressionBackend> git::CompressionBackend::createDefault() {
+    return create(getAvailable().front());
+}
+
+std::vector<std::string> git::CompressionBackend::getAvailable() {
+    std::vector<std::string> names;
+#ifdef GIT_USE_LIBDEFLATE
+    names.push_back("libdeflate");
+#endif
+    names.push_back("zlib");
+    return names;
+}
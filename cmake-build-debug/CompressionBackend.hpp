@@ -0,0 +1,39 @@
+#ifndef PROBA_COMPRESSIONBACKEND_HPP
+#define PROBA_COMPRESSIONBACKEND_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+// zlib kompresija objekata; implementacija se bira u toku rada
+// (libdeflate je dostupan samo uz GIT_USE_LIBDEFLATE)
+class CompressionBackend {
+public:
+    static constexpr int kDefaultLevel = 1;
+
+    virtual ~CompressionBackend() = default;
+
+    static std::unique_ptr<CompressionBackend> create(const std::string& name);
+    static std::unique_ptr<CompressionBackend> createDefault();
+    static std::vector<std::string> getAvailable();
+
+    virtual const char* getName() const = 0;
+
+    virtual void compress(const unsigned char* data, size_t size, int level,
+                          std::string& out) const = 0;
+
+    // sizeHint je ocekivana velicina izlaza ako je poznata, inace 0
+    virtual void decompress(const unsigned char* data, size_t size, size_t sizeHint,
+                            std::string& out) const = 0;
+
+    // dekompresuje samo prvih maxSize bajtova, dovoljno za zaglavlje loose objekta
+    virtual void decompressPrefix(const unsigned char* data, size_t size, size_t maxSize,
+                                  std::string& out) const;
+};
+
+}
+
+#endif
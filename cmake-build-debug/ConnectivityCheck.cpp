@@ -0,0 +1,402 @@
+#include "ConnectivityCheck.hpp"
+
+#include "Branch.hpp"
+#include "ObjectHasher.hpp"
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const std::chrono::milliseconds kIdleWait(1);
+
+// pokazivac iza kraja linije koja pocinje sa prefix, ili nullptr
+const char* matchLine(const char* line, const char* end, const char* prefix) {
+    size_t length = std::strlen(prefix);
+    if (static_cast<size_t>(end - line) < length || std::memcmp(line, prefix, length) != 0) {
+        return nullptr;
+    }
+    return line + length;
+}
+
+bool parseHex(const char* data, const char* end, size_t hexSize, git_oid* oid) {
+    if (static_cast<size_t>(end - data) < hexSize) {
+        return false;
+    }
+    return git_oid_fromstrn(oid, data, hexSize) == 0;
+}
+
+}
+
+bool git::ConnectivityCheck::Report::isClean() const {
+    return missing.empty() && corrupt.empty();
+}
+
+size_t git::ConnectivityCheck::Report::getObjectCount() const {
+    return commits + trees + blobs + tags;
+}
+
+size_t git::ConnectivityCheck::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::ConnectivityCheck::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+git::ConnectivityCheck::ConnectivityCheck(Repository* repo, unsigned threads)
+    : _repo(repo), _threads(threads) {}
+
+git::ConnectivityCheck::~ConnectivityCheck() {
+    if (_odb) {
+        git_odb_free(_odb);
+    }
+}
+
+std::unique_ptr<git::ConnectivityCheck> git::ConnectivityCheck::create(Repository* repo,
+                                                                      unsigned threads) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::unique_ptr<ConnectivityCheck> check(new ConnectivityCheck(repo, threads));
+    check->_hasher = ObjectHasher::forRepository(repo);
+    if (git_repository_odb(&check->_odb, repo->_repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return check;
+}
+
+void git::ConnectivityCheck::setVerifyHashes(bool verify) {
+    _verifyHashes = verify;
+}
+
+git::ConnectivityCheck::Report git::ConnectivityCheck::run() {
+    _verified.clear();
+
+    std::vector<git_oid> tips = readBranchTips();
+    Report report             = check(tips);
+    if (report.isClean()) {
+        writeVerifiedTips(tips);
+    }
+    return report;
+}
+
+git::ConnectivityCheck::Report git::ConnectivityCheck::runIncremental() {
+    std::vector<git_oid> verified = readVerifiedTips();
+    if (verified.empty()) {
+        return run();
+    }
+
+    std::vector<git_oid> tips = readBranchTips();
+    _verified.clear();
+
+    git_revwalk* walk = nullptr;
+    if (git_revwalk_new(&walk, _repo->_repo) != 0) {
+        throw std::runtime_error("Failed to create revision walker: " +
+                                 std::string(git_error_last()->message));
+    }
+    int error = 0;
+    for (size_t i = 0; error == 0 && i < tips.size(); ++i) {
+        error = git_revwalk_push(walk, &tips[i]);
+    }
+    for (size_t i = 0; error == 0 && i < verified.size(); ++i) {
+        error = git_revwalk_hide(walk, &verified[i]);
+    }
+
+    std::vector<git_oid> commits;
+    git_oid oid;
+    while (error == 0 && (error = git_revwalk_next(&oid, walk)) == 0) {
+        commits.push_back(oid);
+    }
+    git_revwalk_free(walk);
+    if (error != GIT_ITEROVER) {
+        throw std::runtime_error("Revision walk failed: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    // granica = roditelji novih commit-a koji su vec bili provereni
+    OidHashSet fresh(commits.begin(), commits.end());
+    for (const git_oid& id : commits) {
+        git_commit* commit = nullptr;
+        if (git_commit_lookup(&commit, _repo->_repo, &id) != 0) {
+            continue;
+        }
+        for (unsigned int i = 0; i < git_commit_parentcount(commit); ++i) {
+            const git_oid* parentId = git_commit_parent_id(commit, i);
+            if (fresh.count(*parentId) || !_verified.insert(*parentId).second) {
+                continue;
+            }
+            git_commit* parent = nullptr;
+            if (git_commit_lookup(&parent, _repo->_repo, parentId) == 0) {
+                markVerifiedTree(git_commit_tree_id(parent));
+                git_commit_free(parent);
+            }
+        }
+        git_commit_free(commit);
+    }
+
+    Report report = check(commits);
+    if (report.isClean()) {
+        writeVerifiedTips(tips);
+    }
+    return report;
+}
+
+std::string git::ConnectivityCheck::getStatePath() const {
+    return std::string(git_repository_path(_repo->_repo)) + kStateFile;
+}
+
+std::vector<git_oid> git::ConnectivityCheck::readBranchTips() const {
+    std::vector<git_oid> tips;
+    for (const auto& branch : Branch::getAllBranches(_repo)) {
+        tips.push_back(*git_commit_id(branch->getLastCommit()->_commit));
+    }
+    return tips;
+}
+
+std::vector<git_oid> git::ConnectivityCheck::readVerifiedTips() const {
+    std::vector<git_oid> tips;
+    std::ifstream in(getStatePath());
+    std::string line;
+    while (std::getline(in, line)) {
+        git_oid oid;
+        // vrh koji je u meduvremenu obrisan (gc) ne moze biti granica
+        if (git_oid_fromstrn(&oid, line.data(), line.size()) == 0 &&
+            git_odb_exists(_odb, &oid)) {
+            tips.push_back(oid);
+        }
+    }
+    return tips;
+}
+
+void git::ConnectivityCheck::writeVerifiedTips(const std::vector<git_oid>& tips) const {
+    std::string path      = getStatePath();
+    std::string temporary = path + ".lock";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        char hex[GIT_OID_HEXSZ + 1] = {};
+        for (const git_oid& tip : tips) {
+            git_oid_fmt(hex, &tip);
+            out << hex << "\n";
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + temporary + " to " + path);
+    }
+}
+
+void git::ConnectivityCheck::markVerifiedTree(const git_oid* treeId) {
+    if (!_verified.insert(*treeId).second) {
+        return;
+    }
+
+    git_tree* tree = nullptr;
+    if (git_tree_lookup(&tree, _repo->_repo, treeId) != 0) {
+        return;
+    }
+    for (size_t i = 0; i < git_tree_entrycount(tree); ++i) {
+        const git_tree_entry* entry = git_tree_entry_byindex(tree, i);
+        if (git_tree_entry_type(entry) == GIT_OBJECT_TREE) {
+            markVerifiedTree(git_tree_entry_id(entry));
+        } else {
+            _verified.insert(*git_tree_entry_id(entry));
+        }
+    }
+    git_tree_free(tree);
+}
+
+git::ConnectivityCheck::Report git::ConnectivityCheck::check(const std::vector<git_oid>& roots) {
+    _shards.clear();
+    for (unsigned i = 0; i < _threads; ++i) {
+        _shards.emplace_back(new Shard());
+    }
+    _pending = 0;
+    _skipped = 0;
+
+    for (const git_oid& root : roots) {
+        push(&root, GIT_OBJECT_COMMIT);
+    }
+
+    std::vector<Report> reports(_threads);
+    auto work = [this, &reports](size_t shard) {
+        Work item;
+        while (true) {
+            if (pop(shard, &item)) {
+                process(item, reports[shard]);
+                if (--_pending == 0) {
+                    _idle.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_idleMutex);
+            if (_idle.wait_for(lock, kIdleWait, [this]() { return _pending == 0; })) {
+                return;
+            }
+        }
+    };
+
+    // jedan deo po shard-u; niti scheduler-a zive samo dok traje provera
+    auto scheduler = TaskScheduler::create(_repo, _threads);
+    scheduler->parallelFor(_threads, 1, [&work](size_t begin, size_t) { work(begin); });
+
+    Report report;
+    for (Report& part : reports) {
+        report.commits += part.commits;
+        report.trees += part.trees;
+        report.blobs += part.blobs;
+        report.tags += part.tags;
+        std::move(part.missing.begin(), part.missing.end(), std::back_inserter(report.missing));
+        std::move(part.corrupt.begin(), part.corrupt.end(), std::back_inserter(report.corrupt));
+    }
+    report.skipped = _skipped;
+    _shards.clear();
+    return report;
+}
+
+void git::ConnectivityCheck::push(const git_oid* oid, git_object_t expected) {
+    if (_verified.count(*oid)) {
+        ++_skipped;
+        return;
+    }
+
+    Shard& shard = *_shards[oid->id[0] % _shards.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.seen.insert(*oid).second) {
+            return;
+        }
+        ++_pending;
+        shard.queue.push_back({*oid, expected});
+    }
+    _idle.notify_one();
+}
+
+bool git::ConnectivityCheck::pop(size_t shard, Work* work) {
+    // prvo sopstveni shard, pa tudji kada je sopstveni prazan
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        Shard& current = *_shards[(shard + i) % _shards.size()];
+        std::lock_guard<std::mutex> lock(current.mutex);
+        if (!current.queue.empty()) {
+            *work = current.queue.back();
+            current.queue.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void git::ConnectivityCheck::process(const Work& work, Report& report) {
+    git_odb_object* object = nullptr;
+    int error              = git_odb_read(&object, _odb, &work.oid);
+    if (error == GIT_ENOTFOUND) {
+        report.missing.push_back({work.oid, "object is missing"});
+        return;
+    }
+    if (error != 0) {
+        report.corrupt.push_back({work.oid, git_error_last()->message});
+        return;
+    }
+
+    git_object_t type = git_odb_object_type(object);
+    const char* data  = static_cast<const char*>(git_odb_object_data(object));
+    size_t size       = git_odb_object_size(object);
+    const char* end   = data + size;
+    size_t hexSize    = _hasher->getDigestSize() * 2;
+
+    if (type != work.expected) {
+        report.corrupt.push_back({work.oid, "expected " +
+                                                std::string(git_object_type2string(work.expected)) +
+                                                ", found " + git_object_type2string(type)});
+        git_odb_object_free(object);
+        return;
+    }
+    if (_verifyHashes && !_hasher->verifyObject(work.oid.id, type, data, size)) {
+        report.corrupt.push_back({work.oid, "hash mismatch"});
+        git_odb_object_free(object);
+        return;
+    }
+
+    git_oid id;
+    if (type == GIT_OBJECT_COMMIT) {
+        ++report.commits;
+        const char* line = data;
+        bool hasTree     = false;
+        while (line < end && *line != '\n') {
+            const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            eol             = eol ? eol : end;
+            const char* value;
+            if ((value = matchLine(line, eol, "tree ")) && parseHex(value, eol, hexSize, &id)) {
+                push(&id, GIT_OBJECT_TREE);
+                hasTree = true;
+            } else if ((value = matchLine(line, eol, "parent ")) &&
+                       parseHex(value, eol, hexSize, &id)) {
+                push(&id, GIT_OBJECT_COMMIT);
+            }
+            line = eol + 1;
+        }
+        if (!hasTree) {
+            report.corrupt.push_back({work.oid, "commit has no tree"});
+        }
+    } else if (type == GIT_OBJECT_TREE) {
+        ++report.trees;
+        size_t oidSize = _hasher->getDigestSize();
+        const char* p  = data;
+        while (p < end) {
+            const char* space = static_cast<const char*>(std::memchr(p, ' ', end - p));
+            const char* name  = space ? space + 1 : end;
+            const char* nul   = static_cast<const char*>(std::memchr(name, '\0', end - name));
+            if (!space || !nul || static_cast<size_t>(end - nul - 1) < oidSize) {
+                report.corrupt.push_back({work.oid, "malformed tree entry"});
+                break;
+            }
+
+            std::memset(&id, 0, sizeof(id));
+            std::memcpy(id.id, nul + 1, std::min(oidSize, sizeof(id.id)));
+            std::string mode(p, space);
+            // gitlink pokazuje na commit u drugom repozitorijumu
+            if (mode == "40000") {
+                push(&id, GIT_OBJECT_TREE);
+            } else if (mode != "160000") {
+                push(&id, GIT_OBJECT_BLOB);
+            }
+            p = nul + 1 + oidSize;
+        }
+    } else if (type == GIT_OBJECT_TAG) {
+        ++report.tags;
+        const char* eol   = static_cast<const char*>(std::memchr(data, '\n', size));
+        const char* value = eol ? matchLine(data, eol, "object ") : nullptr;
+        const char* next  = eol ? eol + 1 : end;
+        const char* eol2  = static_cast<const char*>(std::memchr(next, '\n', end - next));
+        const char* name  = eol2 ? matchLine(next, eol2, "type ") : nullptr;
+        git_object_t target =
+            name ? git_object_string2type(std::string(name, eol2).c_str()) : GIT_OBJECT_INVALID;
+
+        if (value && parseHex(value, eol, hexSize, &id) && target != GIT_OBJECT_INVALID) {
+            push(&id, target);
+        } else {
+            report.corrupt.push_back({work.oid, "malformed tag"});
+        }
+    } else {
+        ++report.blobs;
+    }
+
+    git_odb_object_free(object);
+}
@@ -0,0 +1,110 @@
+#ifndef PROBA_CONNECTIVITYCHECK_HPP
+#define PROBA_CONNECTIVITYCHECK_HPP
+
+#include <git2.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace git {
+
+class ObjectHasher;
+class Repository;
+
+// paralelna provera povezanosti i integriteta objekata dostupnih iz vrhova svih grana;
+// posao je podeljen u shardove po prvom bajtu OID-a, pa svaki shard sam vodi evidenciju
+// vec vidjenih objekata
+class ConnectivityCheck {
+public:
+    static constexpr const char* kStateFile = "proba-verified-tips";
+
+    struct Problem {
+        git_oid oid;
+        std::string message;
+    };
+
+    struct Report {
+        size_t commits = 0;
+        size_t trees   = 0;
+        size_t blobs   = 0;
+        size_t tags    = 0;
+        size_t skipped = 0;
+        std::vector<Problem> missing;
+        std::vector<Problem> corrupt;
+
+        bool isClean() const;
+        size_t getObjectCount() const;
+    };
+
+    ConnectivityCheck(const ConnectivityCheck&)            = delete;
+    ConnectivityCheck& operator=(const ConnectivityCheck&) = delete;
+    ~ConnectivityCheck();
+
+    static std::unique_ptr<ConnectivityCheck> create(Repository* repo, unsigned threads = 0);
+
+    // bez provere hesa proverava se samo prisustvo objekata i ispravnost njihovog sadrzaja
+    void setVerifyHashes(bool verify);
+
+    Report run();
+
+    // proverava samo commit-e nastale posle poslednje uspesne provere; objekti iz stabala
+    // granicnih commit-a smatraju se vec proverenim
+    Report runIncremental();
+
+    std::string getStatePath() const;
+
+private:
+    struct Work {
+        git_oid oid;
+        git_object_t expected;
+    };
+
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+    typedef std::unordered_set<git_oid, OidHash, OidEqual> OidHashSet;
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Work> queue;
+        OidHashSet seen;
+    };
+
+    ConnectivityCheck(Repository* repo, unsigned threads);
+
+    std::vector<git_oid> readBranchTips() const;
+    std::vector<git_oid> readVerifiedTips() const;
+    void writeVerifiedTips(const std::vector<git_oid>& tips) const;
+    void markVerifiedTree(const git_oid* treeId);
+
+    Report check(const std::vector<git_oid>& roots);
+    void push(const git_oid* oid, git_object_t expected);
+    bool pop(size_t shard, Work* work);
+    void process(const Work& work, Report& report);
+
+    Repository* _repo;
+    unsigned _threads;
+    bool _verifyHashes = true;
+    std::unique_ptr<ObjectHasher> _hasher;
+    git_odb* _odb = nullptr;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+    OidHashSet _verified;
+    std::atomic<size_t> _pending{0};
+    std::atomic<size_t> _skipped{0};
+    std::mutex _idleMutex;
+    std::condition_variable _idle;
+};
+
+}
+
+#endif
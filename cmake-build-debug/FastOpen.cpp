@@ -0,0 +1,186 @@
+#include "FastOpen.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const int kConfigLevels[] = {GIT_CONFIG_LEVEL_SYSTEM, GIT_CONFIG_LEVEL_XDG,
+                             GIT_CONFIG_LEVEL_GLOBAL};
+
+std::mutex optionsMutex;
+
+// menja globalna podesavanja samo za vreme otvaranja: provera vlasnika se radi pri
+// otvaranju, a konfiguracija se tada ucitava i ostaje u handle-u
+class ScopedOptions {
+public:
+    explicit ScopedOptions(const git::FastOpen::Options& options) : _options(options) {
+        if (_options.skipOwnerValidation) {
+            git_libgit2_opts(GIT_OPT_GET_OWNER_VALIDATION, &_ownerValidation);
+            git_libgit2_opts(GIT_OPT_SET_OWNER_VALIDATION, 0);
+        }
+        if (_options.skipGlobalConfig) {
+            for (size_t i = 0; i < 3; ++i) {
+                git_buf path = {nullptr, 0, 0};
+                if (git_libgit2_opts(GIT_OPT_GET_SEARCH_PATH, kConfigLevels[i], &path) == 0) {
+                    _searchPaths[i] = path.ptr ? path.ptr : "";
+                }
+                git_buf_dispose(&path);
+                // prazna putanja pretrage: libgit2 ne trazi ni ne parsira te fajlove
+                git_libgit2_opts(GIT_OPT_SET_SEARCH_PATH, kConfigLevels[i], "");
+            }
+        }
+    }
+
+    ~ScopedOptions() {
+        if (_options.skipOwnerValidation) {
+            git_libgit2_opts(GIT_OPT_SET_OWNER_VALIDATION, _ownerValidation);
+        }
+        if (_options.skipGlobalConfig) {
+            for (size_t i = 0; i < 3; ++i) {
+                git_libgit2_opts(GIT_OPT_SET_SEARCH_PATH, kConfigLevels[i],
+                                 _searchPaths[i].c_str());
+            }
+        }
+    }
+
+    ScopedOptions(const ScopedOptions&)            = delete;
+    ScopedOptions& operator=(const ScopedOptions&) = delete;
+
+private:
+    git::FastOpen::Options _options;
+    int _ownerValidation = 1;
+    std::string _searchPaths[3];
+};
+
+}
+
+git::FastOpen::FastOpen(git_repository* repo) : _repo(repo) {}
+
+git::FastOpen::~FastOpen() {
+    if (_refdb) {
+        git_refdb_free(_refdb);
+    }
+    if (_odb) {
+        git_odb_free(_odb);
+    }
+    if (_config) {
+        git_config_free(_config);
+    }
+    if (_repo) {
+        git_repository_free(_repo);
+    }
+}
+
+std::unique_ptr<git::FastOpen> git::FastOpen::open(const std::string& gitdir) {
+    return open(gitdir, Options());
+}
+
+std::unique_ptr<git::FastOpen> git::FastOpen::open(const std::string& gitdir,
+                                                   const Options& options) {
+    if (gitdir.empty()) {
+        throw std::invalid_argument("Git directory is empty.");
+    }
+
+    git_repository* repo = nullptr;
+    int error;
+    {
+        std::lock_guard<std::mutex> lock(optionsMutex);
+        ScopedOptions scoped(options);
+        error = git_repository_open_ext(
+            &repo, gitdir.c_str(), GIT_REPOSITORY_OPEN_NO_SEARCH | GIT_REPOSITORY_OPEN_NO_DOTGIT,
+            nullptr);
+        if (error == 0 && options.skipGlobalConfig) {
+            // konfiguracija se ucitava dok je pretraga jos prazna i ostaje u handle-u
+            git_config* config = nullptr;
+            error              = git_repository_config(&config, repo);
+            git_config_free(config);
+        }
+    }
+    if (error != 0) {
+        git_repository_free(repo);
+        throw std::runtime_error("Failed to open repository " + gitdir + ": " +
+                                 std::string(git_error_last()->message));
+    }
+    return std::unique_ptr<FastOpen>(new FastOpen(repo));
+}
+
+git_repository* git::FastOpen::getRepository() const {
+    return _repo;
+}
+
+git_repository* git::FastOpen::release() {
+    // kesirani delovi pripadaju handle-u koji se predaje, pa se ovde samo otpustaju
+    if (_refdb) {
+        git_refdb_free(_refdb);
+        _refdb = nullptr;
+    }
+    if (_odb) {
+        git_odb_free(_odb);
+        _odb = nullptr;
+    }
+    if (_config) {
+        git_config_free(_config);
+        _config = nullptr;
+    }
+    _strings.clear();
+
+    git_repository* repo = _repo;
+    _repo                = nullptr;
+    return repo;
+}
+
+git_config* git::FastOpen::getConfig() {
+    if (!_repo) {
+        throw std::logic_error("Repository was released.");
+    }
+    if (!_config && git_repository_config_snapshot(&_config, _repo) != 0) {
+        throw std::runtime_error("Failed to read repository config: " +
+                                 std::string(git_error_last()->message));
+    }
+    return _config;
+}
+
+std::string git::FastOpen::getString(const std::string& key, const std::string& fallback) {
+    auto cached = _strings.find(key);
+    if (cached != _strings.end()) {
+        return cached->second;
+    }
+
+    const char* value = nullptr;
+    if (git_config_get_string(&value, getConfig(), key.c_str()) != 0) {
+        return fallback;
+    }
+    return _strings[key] = value;
+}
+
+bool git::FastOpen::getBool(const std::string& key, bool fallback) {
+    int value = 0;
+    if (git_config_get_bool(&value, getConfig(), key.c_str()) != 0) {
+        return fallback;
+    }
+    return value != 0;
+}
+
+git_odb* git::FastOpen::getOdb() {
+    if (!_repo) {
+        throw std::logic_error("Repository was released.");
+    }
+    if (!_odb && git_repository_odb(&_odb, _repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return _odb;
+}
+
+git_refdb* git::FastOpen::getRefdb() {
+    if (!_repo) {
+        throw std::logic_error("Repository was released.");
+    }
+    if (!_refdb && git_repository_refdb(&_refdb, _repo) != 0) {
+        throw std::runtime_error("Failed to open reference database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return _refdb;
+}
@@ -0,0 +1,58 @@
+#ifndef PROBA_FASTOPEN_HPP
+#define PROBA_FASTOPEN_HPP
+
+#include <git2.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace git {
+
+// brzo otvaranje za kratke CLI pozive: tacan gitdir bez pretrage navise i bez dodavanja
+// .git; snapshot konfiguracije, ODB i refdb se prave tek na prvi zahtev
+class FastOpen {
+public:
+    // oba podesavanja su globalna u libgit2; menjaju se samo dok traje open(), pa se
+    // vracaju prethodne vrednosti (open() sa njima je serijalizovan, ali drugi kod koji
+    // u istom trenutku otvara repozitorijum vidi izmenjene vrednosti)
+    struct Options {
+        // provera vlasnika direktorijuma radi stat nad svakim roditeljem; iskljucuje
+        // safe.directory zastitu, pa samo za direktorijume kojima se veruje
+        bool skipOwnerValidation = false;
+        // sistemska/XDG/globalna konfiguracija se ne cita za ovaj handle
+        bool skipGlobalConfig = false;
+    };
+
+    FastOpen(const FastOpen&)            = delete;
+    FastOpen& operator=(const FastOpen&) = delete;
+    ~FastOpen();
+
+    static std::unique_ptr<FastOpen> open(const std::string& gitdir);
+    static std::unique_ptr<FastOpen> open(const std::string& gitdir, const Options& options);
+
+    git_repository* getRepository() const;
+
+    // predaje handle pozivaocu (npr. Repository omotacu); posle toga objekat je prazan
+    git_repository* release();
+
+    git_config* getConfig();
+    std::string getString(const std::string& key, const std::string& fallback = "");
+    bool getBool(const std::string& key, bool fallback = false);
+
+    git_odb* getOdb();
+    git_refdb* getRefdb();
+
+private:
+    explicit FastOpen(git_repository* repo);
+
+    git_repository* _repo;
+    git_config* _config = nullptr;
+    git_odb* _odb       = nullptr;
+    git_refdb* _refdb   = nullptr;
+    std::map<std::string, std::string> _strings;
+};
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include "IncrementalTree.hpp"
+
+#include <stdexcept>
+
+git::IncrementalTree::IncrementalTree(git_repository* repo, git_index* index)
+    : _repo(repo), _index(index) {}
+
+std::vector<std::string> git::IncrementalTree::changedPaths(git_repository* repo,
+                                                            git_tree* base, git_index* index) {
+    git_diff* diff           = nullptr;
+    git_diff_options options = GIT_DIFF_OPTIONS_INIT;
+    if (git_diff_tree_to_index(&diff, repo, base, index, &options) != 0) {
+        throw std::runtime_error("Failed to diff tree against index: " +
+                                 std::string(git_error_last()->message));
+    }
+    return deltaPaths(diff);
+}
+
+std::vector<std::string> git::IncrementalTree::changedPaths(git_repository* repo,
+                                                            git_tree* base, git_tree* other) {
+    git_diff* diff           = nullptr;
+    git_diff_options options = GIT_DIFF_OPTIONS_INIT;
+    if (git_diff_tree_to_tree(&diff, repo, base, other, &options) != 0) {
+        throw std::runtime_error("Failed to diff trees: " +
+                                 std::string(git_error_last()->message));
+    }
+    return deltaPaths(diff);
+}
+
+std::vector<std::string> git::IncrementalTree::deltaPaths(git_diff* diff) {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < git_diff_num_deltas(diff); ++i) {
+        const git_diff_delta* delta = git_diff_get_delta(diff, i);
+        paths.push_back(delta->old_file.path);
+        if (std::string(delta->new_file.path) != delta->old_file.path) {
+            paths.push_back(delta->new_file.path);
+        }
+    }
+    git_diff_free(diff);
+    return paths;
+}
+
+git_oid git::IncrementalTree::write(git_repository* repo, git_index* index, git_tree* base) {
+    return write(repo, index, base, changedPaths(repo, base, index));
+}
+
+git_oid git::IncrementalTree::write(git_repository* repo, git_index* index, git_tree* base,
+                                    const std::vector<std::string>& paths) {
+    if (!base) {
+        throw std::invalid_argument("Base tree is null.");
+    }
+
+    IncrementalTree writer(repo, index);
+    for (const std::string& path : paths) {
+        writer.addPath(path);
+    }
+
+    git_oid id = *git_tree_id(base);
+    if (writer._changes.empty()) {
+        return id;
+    }
+    git_oid result;
+    if (!writer.build("", &id, &result)) {
+        // prazno stablo je i dalje ispravan koren
+        git_treebuilder* builder = nullptr;
+        if (git_treebuilder_new(&builder, repo, nullptr) != 0 ||
+            git_treebuilder_write(&result, builder) != 0) {
+            git_treebuilder_free(builder);
+            throw std::runtime_error("Failed to write empty tree: " +
+                                     std::string(git_error_last()->message));
+        }
+        git_treebuilder_free(builder);
+    }
+    return result;
+}
+
+void git::IncrementalTree::addPath(const std::string& path) {
+    std::string directory;
+    std::string rest = path;
+    // svaki direktorijum na putanji dobija ime sledeceg dela kao izmenjeno
+    for (size_t slash = rest.find('/'); slash != std::string::npos; slash = rest.find('/')) {
+        std::string name = rest.substr(0, slash);
+        _changes[directory].insert(name);
+        directory = directory.empty() ? name : directory + "/" + name;
+        rest      = rest.substr(slash + 1);
+    }
+    _changes[directory].insert(rest);
+}
+
+bool git::IncrementalTree::build(const std::string& directory, const git_oid* baseId,
+                                 git_oid* out) {
+    git_tree* base = nullptr;
+    if (baseId && git_tree_lookup(&base, _repo, baseId) != 0) {
+        throw std::runtime_error("Failed to lookup tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_treebuilder* builder = nullptr;
+    if (git_treebuilder_new(&builder, _repo, base) != 0) {
+        git_tree_free(base);
+        throw std::runtime_error("Failed to create tree builder: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_tree_free(base);
+
+    try {
+        for (const std::string& name : _changes[directory]) {
+            std::string path = directory.empty() ? name : directory + "/" + name;
+
+            // fajl u indeksu ima prednost; direktorijum se gradi samo ako fajla nema
+            const git_index_entry* entry = git_index_get_bypath(_index, path.c_str(), 0);
+            if (entry) {
+                if (git_treebuilder_insert(nullptr, builder, name.c_str(), &entry->id,
+                                           static_cast<git_filemode_t>(entry->mode)) != 0) {
+                    throw std::runtime_error("Failed to insert tree entry: " +
+                                             std::string(git_error_last()->message));
+                }
+                continue;
+            }
+
+            git_oid subtree;
+            bool present = false;
+            if (_changes.count(path)) {
+                const git_tree_entry* existing = git_treebuilder_get(builder, name.c_str());
+                bool isTree = existing && git_tree_entry_type(existing) == GIT_OBJECT_TREE;
+                git_oid existingId;
+                if (isTree) {
+                    existingId = *git_tree_entry_id(existing);
+                }
+                present = build(path, isTree ? &existingId : nullptr, &subtree);
+            }
+
+            if (present) {
+                if (git_treebuilder_insert(nullptr, builder, name.c_str(), &subtree,
+                                           GIT_FILEMODE_TREE) != 0) {
+                    throw std::runtime_error("Failed to insert tree entry: " +
+                                             std::string(git_error_last()->message));
+                }
+            } else if (git_treebuilder_get(builder, name.c_str())) {
+                git_treebuilder_remove(builder, name.c_str());
+            }
+        }
+
+        bool empty = git_treebuilder_entrycount(builder) == 0;
+        if (!empty && git_treebuilder_write(out, builder) != 0) {
+            throw std::runtime_error("Failed to write tree: " +
+                                     std::string(git_error_last()->message));
+        }
+        git_treebuilder_free(builder);
+        return !empty;
+    } catch (...) {
+        git_treebuilder_free(builder);
+        throw;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef PROBA_INCREMENTALTREE_HPP
+#define PROBA_INCREMENTALTREE_HPP
+
+#include <git2.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace git {
+
+// upis stabla indeksa kao izmene postojeceg stabla (npr. HEAD-a): nepromenjeni
+// direktorijumi se preuzimaju iz osnovnog stabla po OID-u, a serijalizuju, hesiraju i
+// upisuju se samo direktorijumi na putanji do izmenjenih unosa; posle git_merge-a
+// libgit2 nema ispravan cache-tree, pa git_index_write_tree inace gradi sve direktorijume
+class IncrementalTree {
+public:
+    IncrementalTree(const IncrementalTree&)            = delete;
+    IncrementalTree& operator=(const IncrementalTree&) = delete;
+
+    // putanje u kojima se indeks razlikuje od stabla; poredi samo OID-ove i modove, ali
+    // obilazi celo stablo i ceo indeks
+    static std::vector<std::string> changedPaths(git_repository* repo, git_tree* base,
+                                                 git_index* index);
+    // putanje u kojima se dva stabla razlikuju; isti poddirektorijumi se preskacu po OID-u,
+    // pa je cena srazmerna izmenama
+    static std::vector<std::string> changedPaths(git_repository* repo, git_tree* base,
+                                                 git_tree* other);
+
+    // stablo indeksa, pod uslovom da se indeks od base razlikuje samo u paths; indeks ne
+    // sme imati konflikte
+    static git_oid write(git_repository* repo, git_index* index, git_tree* base,
+                         const std::vector<std::string>& paths);
+
+    // changedPaths + write
+    static git_oid write(git_repository* repo, git_index* index, git_tree* base);
+
+private:
+    IncrementalTree(git_repository* repo, git_index* index);
+
+    // oslobadja diff
+    static std::vector<std::string> deltaPaths(git_diff* diff);
+
+    // izmenjena imena po direktorijumu ("" je koren)
+    void addPath(const std::string& path);
+    // vraca false ako je direktorijum ostao prazan
+    bool build(const std::string& directory, const git_oid* baseId, git_oid* out);
+
+    git_repository* _repo;
+    git_index* _index;
+    std::map<std::string, std::set<std::string>> _changes;
+};
+
+}
+
+#endif
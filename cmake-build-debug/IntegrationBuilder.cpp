@@ -0,0 +1,212 @@
+#include "IntegrationBuilder.hpp"
+
+#include "Branch.hpp"
+#include "CancellationToken.hpp"
+#include "MergeBase.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+git::IntegrationBuilder::IntegrationBuilder(Repository* repo, const std::string& branchName)
+    : _repo(repo), _branchName(branchName) {}
+
+git::IntegrationBuilder::~IntegrationBuilder() = default;
+
+std::unique_ptr<git::IntegrationBuilder> git::IntegrationBuilder::create(
+    Repository* repo, const std::string& branchName) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (branchName.empty()) {
+        throw std::invalid_argument("Branch name is empty.");
+    }
+
+    std::unique_ptr<IntegrationBuilder> builder(new IntegrationBuilder(repo, branchName));
+    builder->_mergeBase = MergeBase::create(repo);
+    return builder;
+}
+
+std::string git::IntegrationBuilder::getStatePath() const {
+    std::string name = _branchName;
+    std::replace(name.begin(), name.end(), '/', '_');
+    return std::string(git_repository_path(_repo->_repo)) + kStatePrefix + name;
+}
+
+bool git::IntegrationBuilder::readState(git_oid* base, std::vector<Step>& steps) const {
+    std::ifstream in(getStatePath());
+    std::string line;
+    if (!std::getline(in, line) || git_oid_fromstrn(base, line.data(), line.size()) != 0) {
+        return false;
+    }
+
+    // red koraka: <vrh topic-a> <rezultat> <konflikt> <sadrzan> <ime>
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tip, result;
+        Step step;
+        if (!(fields >> tip >> result >> step.conflicted >> step.merged) ||
+            git_oid_fromstrn(&step.tip, tip.data(), tip.size()) != 0 ||
+            git_oid_fromstrn(&step.result, result.data(), result.size()) != 0) {
+            break;
+        }
+        fields.get();
+        std::getline(fields, step.name);
+        steps.push_back(step);
+    }
+    return true;
+}
+
+void git::IntegrationBuilder::writeState(const git_oid* base,
+                                         const std::vector<Step>& steps) const {
+    std::string path      = getStatePath();
+    std::string temporary = path + ".lock";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        char hex[GIT_OID_HEXSZ + 1] = {};
+        git_oid_fmt(hex, base);
+        out << hex << "\n";
+        for (const Step& step : steps) {
+            git_oid_fmt(hex, &step.tip);
+            out << hex << " ";
+            git_oid_fmt(hex, &step.result);
+            out << hex << " " << step.conflicted << " " << step.merged << " " << step.name
+                << "\n";
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + temporary + " to " + path);
+    }
+}
+
+std::vector<git::IntegrationBuilder::Step> git::IntegrationBuilder::build(
+    const Branch* base, const std::vector<const Branch*>& topics) {
+    if (!base) {
+        throw std::invalid_argument("Base branch is null.");
+    }
+
+    std::vector<Topic> inputs;
+    for (const Branch* topic : topics) {
+        if (!topic) {
+            throw std::invalid_argument("Topic branch is null.");
+        }
+        inputs.push_back({topic->getBranchName(), *git_commit_id(topic->getLastCommit()->_commit)});
+    }
+    return build(git_commit_id(base->getLastCommit()->_commit), inputs);
+}
+
+std::vector<git::IntegrationBuilder::Step> git::IntegrationBuilder::build(
+    const git_oid* base, const std::vector<Topic>& topics) {
+    git_oid previousBase;
+    std::vector<Step> previous;
+    bool known = readState(&previousBase, previous) && git_oid_equal(&previousBase, base);
+
+    // najduzi pocetni niz sa istim ulazima; rezultat mora jos da postoji (gc)
+    git_odb* odb = nullptr;
+    if (git_repository_odb(&odb, _repo->_repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    std::vector<Step> steps;
+    for (size_t i = 0; known && i < topics.size() && i < previous.size(); ++i) {
+        const Step& old = previous[i];
+        if (old.name != topics[i].name || !git_oid_equal(&old.tip, &topics[i].tip) ||
+            !git_odb_exists(odb, &old.result)) {
+            break;
+        }
+        steps.push_back(old);
+        steps.back().reused = true;
+    }
+    git_odb_free(odb);
+
+    git_oid current = steps.empty() ? *base : steps.back().result;
+    try {
+        for (size_t i = steps.size(); i < topics.size(); ++i) {
+            CancellationScope::check();
+            Step step;
+            step.name = topics[i].name;
+            step.tip  = topics[i].tip;
+            mergeTopic(&current, step);
+            current = step.result;
+            steps.push_back(step);
+        }
+    } catch (const OperationCancelled&) {
+        // zavrseni koraci se pamte, pa sledece gradjenje nastavlja od prekinutog topic-a;
+        // grana ostaje na prethodnom rezultatu
+        writeState(base, steps);
+        throw;
+    }
+
+    git_reference* ref = nullptr;
+    std::string refName = "refs/heads/" + _branchName;
+    if (git_reference_create(&ref, _repo->_repo, refName.c_str(), &current, 1,
+                             "integration: rebuild") != 0) {
+        throw std::runtime_error("Failed to update " + refName + ": " +
+                                 std::string(git_error_last()->message));
+    }
+    git_reference_free(ref);
+
+    writeState(base, steps);
+    return steps;
+}
+
+void git::IntegrationBuilder::mergeTopic(const git_oid* current, Step& step) {
+    step.result = *current;
+
+    // topic koji je vec sadrzan ne pravi prazan merge commit
+    std::vector<git_oid> bases = _mergeBase->findAll(current, &step.tip);
+    if (bases.size() == 1 && git_oid_equal(&bases[0], &step.tip)) {
+        step.merged = true;
+        return;
+    }
+
+    // isti MergeBase za sve korake, pa se virtuelne baze racunaju jednom
+    git_index* index = _mergeBase->merge(current, &step.tip);
+    if (git_index_has_conflicts(index)) {
+        git_index_free(index);
+        step.conflicted = true;
+        return;
+    }
+
+    git_oid treeId;
+    int error = git_index_write_tree_to(&treeId, index, _repo->_repo);
+    git_index_free(index);
+    if (error != 0) {
+        throw std::runtime_error("Failed to write merged tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_tree* tree           = nullptr;
+    git_commit* parents[2]   = {nullptr, nullptr};
+    git_signature* signature = nullptr;
+    if (git_tree_lookup(&tree, _repo->_repo, &treeId) != 0 ||
+        git_commit_lookup(&parents[0], _repo->_repo, current) != 0 ||
+        git_commit_lookup(&parents[1], _repo->_repo, &step.tip) != 0 ||
+        (git_signature_default(&signature, _repo->_repo) != 0 &&
+         git_signature_now(&signature, "Integration", "integration@localhost") != 0)) {
+        git_tree_free(tree);
+        git_commit_free(parents[0]);
+        git_commit_free(parents[1]);
+        throw std::runtime_error("Failed to prepare merge commit: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    std::string message = "Merge branch '" + step.name + "' into " + _branchName;
+    const git_commit* parentList[] = {parents[0], parents[1]};
+    error = git_commit_create(&step.result, _repo->_repo, nullptr, signature, signature, nullptr,
+                              message.c_str(), tree, 2, parentList);
+
+    git_signature_free(signature);
+    git_tree_free(tree);
+    git_commit_free(parents[0]);
+    git_commit_free(parents[1]);
+    if (error != 0) {
+        throw std::runtime_error("Failed to create merge commit: " +
+                                 std::string(git_error_last()->message));
+    }
+}
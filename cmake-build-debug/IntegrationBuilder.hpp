@@ -0,0 +1,66 @@
+#ifndef PROBA_INTEGRATIONBUILDER_HPP
+#define PROBA_INTEGRATIONBUILDER_HPP
+
+#include <git2.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class MergeBase;
+class Repository;
+
+// gradi integracionu granu kao niz merge-ova topic grana na bazu (npr. main); redosled
+// i rezultat svakog koraka se pamte u "proba-integration-<grana>", pa sledece gradjenje
+// preuzima najduzi pocetni niz koraka ciji su ulazi (baza, ime i vrh topic-a) isti i
+// ponovo radi samo od prve promenjene topic grane; topic koji pravi konflikt se preskace
+class IntegrationBuilder {
+public:
+    static constexpr const char* kStatePrefix = "proba-integration-";
+
+    struct Topic {
+        std::string name;
+        git_oid tip;
+    };
+
+    struct Step {
+        std::string name;
+        git_oid tip;
+        git_oid result;
+        bool reused     = false;
+        bool conflicted = false;
+        bool merged     = false;  // topic je vec bio sadrzan, nema novog commit-a
+    };
+
+    IntegrationBuilder(const IntegrationBuilder&)            = delete;
+    IntegrationBuilder& operator=(const IntegrationBuilder&) = delete;
+    ~IntegrationBuilder();
+
+    // branchName bez "refs/heads/"
+    static std::unique_ptr<IntegrationBuilder> create(Repository* repo,
+                                                      const std::string& branchName);
+
+    // postavlja refs/heads/<branchName> na rezultat poslednjeg koraka
+    std::vector<Step> build(const git_oid* base, const std::vector<Topic>& topics);
+    std::vector<Step> build(const Branch* base, const std::vector<const Branch*>& topics);
+
+    std::string getStatePath() const;
+
+private:
+    IntegrationBuilder(Repository* repo, const std::string& branchName);
+
+    bool readState(git_oid* base, std::vector<Step>& steps) const;
+    void writeState(const git_oid* base, const std::vector<Step>& steps) const;
+    void mergeTopic(const git_oid* current, Step& step);
+
+    Repository* _repo;
+    std::string _branchName;
+    std::unique_ptr<MergeBase> _mergeBase;
+};
+
+}
+
+#endif
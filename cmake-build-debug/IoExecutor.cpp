@@ -0,0 +1,252 @@
+#include "IoExecutor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+thread_local git::IoMeter* currentMeter = nullptr;
+
+}
+
+git::IoExecutor::IoExecutor(unsigned threads, const Limits& limits)
+    : _limits(limits),
+      _ioTokens(static_cast<double>(limits.batchIoPerSecond)),
+      _lastRefill(Clock::now()) {
+    for (unsigned i = 0; i < threads; ++i) {
+        _threads.emplace_back(&IoExecutor::work, this);
+    }
+}
+
+git::IoExecutor::~IoExecutor() {
+    // poslovi koji su vec predati se zavrsavaju pre gasenja
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _ready.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+std::unique_ptr<git::IoExecutor> git::IoExecutor::create(unsigned threads) {
+    return create(threads, Limits());
+}
+
+std::unique_ptr<git::IoExecutor> git::IoExecutor::create(unsigned threads,
+                                                        const Limits& limits) {
+    if (threads == 0) {
+        throw std::invalid_argument("Executor needs at least one thread.");
+    }
+    return std::unique_ptr<IoExecutor>(new IoExecutor(threads, limits));
+}
+
+void git::IoExecutor::submit(const void* key, std::function<void()> task) {
+    submit(key, std::move(task), Priority::Interactive);
+}
+
+void git::IoExecutor::submit(const void* key, std::function<void()> task, Priority priority,
+                             uint64_t ioCost) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopping) {
+            throw std::logic_error("Executor is shutting down.");
+        }
+
+        Metrics& metrics = _metrics[static_cast<int>(priority)];
+        if (priority == Priority::Batch && _limits.maxBatchQueued != 0 &&
+            _queuedBatch >= _limits.maxBatchQueued) {
+            ++metrics.rejected;
+            throw std::runtime_error("Batch queue is full.");
+        }
+
+        Strand& strand = _strands[key];
+        Job job{std::move(task), Clock::now(), ioCost};
+        if (priority == Priority::Interactive) {
+            strand.interactive.push_back(std::move(job));
+        } else {
+            strand.batch.push_back(std::move(job));
+            ++_queuedBatch;
+        }
+        ++metrics.submitted;
+        ++_pending;
+
+        if (!strand.scheduled) {
+            strand.scheduled = true;
+            enqueue(key);
+        } else if (priority == Priority::Interactive) {
+            // kljuc koji ceka samo zbog batch posla prelazi u interaktivni red
+            auto found = std::find(_runnableBatch.begin(), _runnableBatch.end(), key);
+            if (found != _runnableBatch.end()) {
+                _runnableBatch.erase(found);
+                _runnable.push_back(key);
+            }
+        }
+    }
+    _ready.notify_one();
+}
+
+git::IoExecutor::Lane git::IoExecutor::lane(Priority priority, uint64_t ioCost) {
+    return Lane(this, priority, ioCost);
+}
+
+void git::IoExecutor::charge(uint64_t ioCost) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_limits.batchIoPerSecond == 0 || ioCost == 0) {
+        return;
+    }
+    refill(Clock::now());
+    _ioTokens -= static_cast<double>(ioCost);
+}
+
+void git::IoExecutor::setLimits(const Limits& limits) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _limits   = limits;
+        _ioTokens = std::min(_ioTokens, static_cast<double>(limits.batchIoPerSecond));
+    }
+    _ready.notify_all();
+}
+
+size_t git::IoExecutor::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending;
+}
+
+git::IoExecutor::Metrics git::IoExecutor::getMetrics(Priority priority) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _metrics[static_cast<int>(priority)];
+}
+
+void git::IoExecutor::enqueue(const void* key) {
+    Strand& strand = _strands[key];
+    if (!strand.interactive.empty()) {
+        _runnable.push_back(key);
+    } else {
+        _runnableBatch.push_back(key);
+    }
+}
+
+void git::IoExecutor::refill(Clock::time_point now) {
+    double rate    = static_cast<double>(_limits.batchIoPerSecond);
+    double elapsed = std::chrono::duration<double>(now - _lastRefill).count();
+    _lastRefill    = now;
+    // budzet se skuplja najvise za jednu sekundu unapred
+    _ioTokens = std::min(rate, _ioTokens + elapsed * rate);
+}
+
+bool git::IoExecutor::take(const void** key, Job* job, Priority* priority,
+                           Clock::time_point* retry) {
+    *retry = Clock::time_point::max();
+    if (!_runnable.empty()) {
+        *key = _runnable.front();
+        _runnable.pop_front();
+        Strand& strand = _strands[*key];
+        *job           = std::move(strand.interactive.front());
+        strand.interactive.pop_front();
+        *priority = Priority::Interactive;
+        return true;
+    }
+    if (_runnableBatch.empty()) {
+        return false;
+    }
+    if (_limits.maxBatchRunning != 0 && _runningBatch >= _limits.maxBatchRunning) {
+        return false;
+    }
+
+    Clock::time_point now = Clock::now();
+    if (_limits.batchIoPerSecond != 0) {
+        refill(now);
+        // posao koji je prekoracio budzet ostavlja dug koji se otplacuje pre sledeceg
+        if (_ioTokens < 0) {
+            double wait = -_ioTokens / static_cast<double>(_limits.batchIoPerSecond);
+            *retry      = now + std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double>(wait));
+            return false;
+        }
+    }
+
+    *key = _runnableBatch.front();
+    _runnableBatch.pop_front();
+    Strand& strand = _strands[*key];
+    *job           = std::move(strand.batch.front());
+    strand.batch.pop_front();
+    *priority = Priority::Batch;
+    if (_limits.batchIoPerSecond != 0) {
+        _ioTokens -= static_cast<double>(job->ioCost);
+    }
+    --_queuedBatch;
+    ++_runningBatch;
+    return true;
+}
+
+void git::IoExecutor::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        const void* key = nullptr;
+        Job job;
+        Priority priority;
+        Clock::time_point retry;
+        if (!take(&key, &job, &priority, &retry)) {
+            if (_stopping && _runnable.empty() && _runnableBatch.empty()) {
+                return;
+            }
+            if (retry == Clock::time_point::max()) {
+                _ready.wait(lock);
+            } else {
+                _ready.wait_until(lock, retry);
+            }
+            continue;
+        }
+
+        auto delay = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                           job.submitted);
+        Metrics& metrics = _metrics[static_cast<int>(priority)];
+        ++metrics.started;
+        metrics.totalDelay += delay;
+        metrics.maxDelay = std::max(metrics.maxDelay, delay);
+
+        lock.unlock();
+        try {
+            job.task();
+        } catch (...) {
+            // Async poslovi sami cuvaju izuzetke; ostali se ne smeju propagirati u nit
+        }
+        job.task = nullptr;
+        lock.lock();
+
+        --_pending;
+        if (priority == Priority::Batch) {
+            --_runningBatch;
+            // oslobodjeno mesto moze da pusti batch posao koji ceka u drugoj niti
+            _ready.notify_all();
+        }
+        // kljuc se vraca na kraj reda, pa jedan repozitorijum ne zauzima nit zauvek
+        Strand& strand = _strands[key];
+        if (strand.interactive.empty() && strand.batch.empty()) {
+            _strands.erase(key);
+        } else {
+            enqueue(key);
+            _ready.notify_one();
+        }
+    }
+}
+
+git::IoMeter::IoMeter() : _previous(currentMeter) {
+    currentMeter = this;
+}
+
+git::IoMeter::~IoMeter() {
+    currentMeter = _previous;
+}
+
+void git::IoMeter::record(uint64_t bytes) {
+    for (IoMeter* meter = currentMeter; meter; meter = meter->_previous) {
+        meter->_bytes += bytes;
+    }
+}
+
+uint64_t git::IoMeter::getBytes() const {
+    return _bytes;
+}
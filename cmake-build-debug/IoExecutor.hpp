@@ -0,0 +1,146 @@
+#ifndef PROBA_IOEXECUTOR_HPP
+#define PROBA_IOEXECUTOR_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace git {
+
+// niti za blokirajuce libgit2 pozive; poslovi sa istim kljucem (npr. Repository*) se
+// izvrsavaju redom, jer git_repository nije bezbedan za istovremene izmene, a poslovi
+// razlicitih kljuceva paralelno
+class IoExecutor {
+public:
+    static constexpr unsigned kDefaultThreads = 4;
+
+    // interaktivni poslovi preticu batch poslove koji jos cekaju u redu (i unutar istog
+    // kljuca i izmedju kljuceva); posao koji se vec izvrsava se ne prekida
+    enum class Priority { Interactive, Batch };
+
+    // ogranicenja za batch poslove; 0 znaci bez ogranicenja
+    struct Limits {
+        unsigned maxBatchRunning  = 0;  // najvise batch poslova istovremeno
+        size_t maxBatchQueued     = 0;  // submit baca izuzetak kada je red pun
+        uint64_t batchIoPerSecond = 0;  // budzet za deklarisani ioCost batch poslova
+    };
+
+    // kasnjenje od submit-a do pocetka izvrsavanja, po klasi prioriteta
+    struct Metrics {
+        uint64_t submitted = 0;
+        uint64_t started   = 0;
+        uint64_t rejected  = 0;
+        std::chrono::microseconds totalDelay{0};
+        std::chrono::microseconds maxDelay{0};
+    };
+
+    // Async::start prima bilo sta sa submit(key, task), pa ovo vezuje prioritet za poslove
+    class Lane {
+    public:
+        void submit(const void* key, std::function<void()> task) {
+            _executor->submit(key, std::move(task), _priority, _ioCost);
+        }
+
+    private:
+        friend class IoExecutor;
+        Lane(IoExecutor* executor, Priority priority, uint64_t ioCost)
+            : _executor(executor), _priority(priority), _ioCost(ioCost) {}
+
+        IoExecutor* _executor;
+        Priority _priority;
+        uint64_t _ioCost;
+    };
+
+    IoExecutor(const IoExecutor&)            = delete;
+    IoExecutor& operator=(const IoExecutor&) = delete;
+    ~IoExecutor();
+
+    static std::unique_ptr<IoExecutor> create(unsigned threads = kDefaultThreads);
+    static std::unique_ptr<IoExecutor> create(unsigned threads, const Limits& limits);
+
+    void submit(const void* key, std::function<void()> task);
+    // ioCost (npr. procena procitanih bajtova) se trosi iz budzeta samo za batch poslove
+    void submit(const void* key, std::function<void()> task, Priority priority,
+                uint64_t ioCost = 0);
+
+    Lane lane(Priority priority, uint64_t ioCost = 0);
+
+    // naplacuje batch budzetu I/O izmeren posle posla (IoMeter), kada se unapred ne zna;
+    // dug odlaze sledeci batch posao kao i prekoraceni ioCost
+    void charge(uint64_t ioCost);
+
+    void setLimits(const Limits& limits);
+
+    size_t getPendingCount() const;
+    Metrics getMetrics(Priority priority) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job {
+        std::function<void()> task;
+        Clock::time_point submitted;
+        uint64_t ioCost;
+    };
+
+    struct Strand {
+        std::deque<Job> interactive;
+        std::deque<Job> batch;
+        bool scheduled = false;
+    };
+
+    IoExecutor(unsigned threads, const Limits& limits);
+
+    void work();
+    void enqueue(const void* key);
+    bool take(const void** key, Job* job, Priority* priority, Clock::time_point* retry);
+    void refill(Clock::time_point now);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _ready;
+    std::map<const void*, Strand> _strands;
+    // kljucevi sa interaktivnim poslom na celu, i oni sa samo batch poslovima
+    std::deque<const void*> _runnable;
+    std::deque<const void*> _runnableBatch;
+    Limits _limits;
+    size_t _pending        = 0;
+    size_t _queuedBatch    = 0;
+    unsigned _runningBatch = 0;
+    double _ioTokens       = 0;
+    Clock::time_point _lastRefill;
+    Metrics _metrics[2];
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+};
+
+// meri I/O operacija tekuce niti bez menjanja potpisa (kao CancellationScope): Branch
+// prijavljuje bajtove koje cita iz packova, a posao ih posle naplacuje preko charge();
+// merenja se mogu ugnezdavati, a prijava vazi za sve otvorene
+class IoMeter {
+public:
+    IoMeter();
+    ~IoMeter();
+
+    IoMeter(const IoMeter&)            = delete;
+    IoMeter& operator=(const IoMeter&) = delete;
+
+    static void record(uint64_t bytes);
+
+    uint64_t getBytes() const;
+
+private:
+    uint64_t _bytes = 0;
+    IoMeter* _previous;
+};
+
+}
+
+#endif
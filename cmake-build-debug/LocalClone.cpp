@@ -0,0 +1,182 @@
+#include "LocalClone.hpp"
+
+#include "Branch.hpp"
+#include "LooseObjectBackend.hpp"
+#include "MirrorSync.hpp"
+
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+std::string resolvePath(const std::string& path) {
+    char resolved[PATH_MAX];
+    if (!realpath(path.c_str(), resolved)) {
+        return path;
+    }
+    return resolved;
+}
+
+// reference se upisuju kao jedna transakcija, kao kod MirrorSync-a
+void copyRefs(git::Repository* source, git_repository* target) {
+    auto refs = git::MirrorSync::readRefs(source);
+
+    git_transaction* transaction = nullptr;
+    if (git_transaction_new(&transaction, target) != 0) {
+        throw std::runtime_error("Failed to start reference transaction: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    const char* message = "local clone";
+    int error           = 0;
+    for (auto it = refs.begin(); error == 0 && it != refs.end(); ++it) {
+        error = git_transaction_lock_ref(transaction, it->first.c_str());
+    }
+    for (auto it = refs.begin(); error == 0 && it != refs.end(); ++it) {
+        if (it->second.symbolic) {
+            error = git_transaction_set_symbolic_target(transaction, it->first.c_str(),
+                                                        it->second.symbolicTarget.c_str(),
+                                                        nullptr, message);
+        } else {
+            error = git_transaction_set_target(transaction, it->first.c_str(), &it->second.id,
+                                               nullptr, message);
+        }
+    }
+    if (error == 0) {
+        error = git_transaction_commit(transaction);
+    }
+    git_transaction_free(transaction);
+
+    if (error != 0) {
+        throw std::runtime_error("Failed to copy references: " +
+                                 std::string(git_error_last()->message));
+    }
+}
+
+void copyHead(git::Repository* source, git_repository* target) {
+    git_reference* head = nullptr;
+    if (git_reference_lookup(&head, source->_repo, "HEAD") != 0) {
+        throw std::runtime_error("Failed to read HEAD: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    int error = 0;
+    if (git_reference_type(head) == GIT_REFERENCE_SYMBOLIC) {
+        error = git_repository_set_head(target, git_reference_symbolic_target(head));
+    } else {
+        error = git_repository_set_head_detached(target, git_reference_target(head));
+    }
+    git_reference_free(head);
+
+    if (error != 0) {
+        throw std::runtime_error("Failed to set HEAD: " + std::string(git_error_last()->message));
+    }
+}
+
+}
+
+void git::LocalClone::clone(Repository* source, const std::string& path, bool bare) {
+    if (!source) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    git_repository_init_options options = GIT_REPOSITORY_INIT_OPTIONS_INIT;
+    options.flags = GIT_REPOSITORY_INIT_MKPATH | GIT_REPOSITORY_INIT_NO_REINIT;
+    if (bare) {
+        options.flags |= GIT_REPOSITORY_INIT_BARE;
+    }
+
+    git_repository* repo = nullptr;
+    if (git_repository_init_ext(&repo, path.c_str(), &options) != 0) {
+        throw std::runtime_error("Failed to initialize repository: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    std::string objects = std::string(git_repository_commondir(repo)) + "objects/";
+    git_repository_free(repo);
+
+    // objekti izvora se pozajmljuju, ne kopiraju
+    {
+        std::ofstream alternates(objects + "info/alternates");
+        alternates << resolvePath(LooseObjectBackend::getObjectsDirectory(source)) << "\n";
+        if (!alternates) {
+            throw std::runtime_error("Failed to write " + objects + "info/alternates");
+        }
+    }
+
+    // ponovo otvaramo da bi ODB ucitao alternates
+    if (git_repository_open(&repo, path.c_str()) != 0) {
+        throw std::runtime_error("Failed to open cloned repository: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    try {
+        copyRefs(source, repo);
+        copyHead(source, repo);
+
+        if (!bare) {
+            git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+            opts.checkout_strategy    = GIT_CHECKOUT_SAFE;
+            if (git_checkout_head(repo, &opts) != 0) {
+                throw std::runtime_error("Checkout failed: " +
+                                         std::string(git_error_last()->message));
+            }
+        }
+    } catch (...) {
+        git_repository_free(repo);
+        throw;
+    }
+    git_repository_free(repo);
+}
+
+bool git::LocalClone::borrowsFrom(Repository* repo, Repository* source) {
+    if (!repo || !source) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::string objects  = LooseObjectBackend::getObjectsDirectory(repo);
+    std::string borrowed = resolvePath(LooseObjectBackend::getObjectsDirectory(source));
+
+    std::ifstream alternates(objects + "info/alternates");
+    std::string line;
+    while (std::getline(alternates, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (resolvePath(line[0] == '/' ? line : objects + line) == borrowed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<git::Branch> git::LocalClone::moveBranch(const Branch* branch, Repository* target,
+                                                        bool force) {
+    if (!branch) {
+        throw std::invalid_argument("Branch is null.");
+    }
+    if (!target) {
+        throw std::invalid_argument("Target repository is null.");
+    }
+
+    const git_oid* tip = git_commit_id(branch->getLastCommit()->_commit);
+
+    git_commit* commit = nullptr;
+    if (git_commit_lookup(&commit, target->_repo, tip) != 0) {
+        throw std::runtime_error("Branch tip is not available in target repository: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_reference* ref = nullptr;
+    int error = git_branch_create(&ref, target->_repo, branch->getBranchName().c_str(), commit,
+                                  force ? 1 : 0);
+    git_commit_free(commit);
+    if (error != 0) {
+        throw std::runtime_error("Failed to create branch in target repository: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    return Branch::create(ref, target);
+}
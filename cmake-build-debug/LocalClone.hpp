@@ -0,0 +1,30 @@
+#ifndef PROBA_LOCALCLONE_HPP
+#define PROBA_LOCALCLONE_HPP
+
+#include <git2.h>
+
+#include <memory>
+#include <string>
+
+namespace git {
+
+class Branch;
+class Repository;
+
+// lokalni klon bez kopiranja objekata: novi repozitorijum cita objekte izvora preko
+// objects/info/alternates, a kopiraju se samo reference
+class LocalClone {
+public:
+    static void clone(Repository* source, const std::string& path, bool bare = false);
+
+    static bool borrowsFrom(Repository* repo, Repository* source);
+
+    // pravi granu sa istim imenom i vrhom u target repozitorijumu; objekti se ne kopiraju,
+    // pa vrh mora vec biti dostupan u targetu (npr. preko alternates)
+    static std::unique_ptr<Branch> moveBranch(const Branch* branch, Repository* target,
+                                              bool force = false);
+};
+
+}
+
+#endif
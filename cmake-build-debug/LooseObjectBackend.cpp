@@ -0,0 +1,390 @@
+#include "LooseObjectBackend.hpp"
+
+#include "Branch.hpp"
+#include "CompressionBackend.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace {
+
+const size_t kMaxHeaderSize = 64;
+
+struct LooseBackend : git_odb_backend {
+    std::string directory;
+    std::unique_ptr<git::CompressionBackend> compression;
+    int level;
+
+    std::string objectPath(const git_oid* oid) const {
+        char hex[GIT_OID_HEXSZ + 1] = {};
+        git_oid_fmt(hex, oid);
+        return directory + std::string(hex, 2) + "/" + std::string(hex + 2);
+    }
+};
+
+LooseBackend* self(git_odb_backend* backend) {
+    return static_cast<LooseBackend*>(backend);
+}
+
+int reportError(const std::exception& e) {
+    git_error_set_str(GIT_ERROR_ODB, e.what());
+    return GIT_ERROR;
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat " + path);
+    }
+
+    out.resize(static_cast<size_t>(st.st_size));
+    size_t done = 0;
+    while (done < out.size()) {
+        ssize_t n = ::read(fd, &out[done], out.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to read " + path);
+        }
+        done += static_cast<size_t>(n);
+    }
+
+    ::close(fd);
+    return true;
+}
+
+// zaglavlje loose objekta: "<tip> <velicina>\0"
+size_t parseHeader(const std::string& data, git_object_t* type, size_t* size) {
+    size_t space = data.find(' ');
+    size_t end   = data.find('\0');
+    if (space == std::string::npos || end == std::string::npos || space > end) {
+        throw std::runtime_error("Corrupt loose object header.");
+    }
+
+    *type = git_object_string2type(data.substr(0, space).c_str());
+    if (*type == GIT_OBJECT_INVALID) {
+        throw std::runtime_error("Unknown loose object type.");
+    }
+
+    char* last = nullptr;
+    *size      = std::strtoull(data.c_str() + space + 1, &last, 10);
+    if (last != data.c_str() + end) {
+        throw std::runtime_error("Corrupt loose object size.");
+    }
+    return end + 1;
+}
+
+size_t readHeader(LooseBackend* backend, const std::string& compressed, git_object_t* type,
+                  size_t* size) {
+    std::string header;
+    backend->compression->decompressPrefix(
+        reinterpret_cast<const unsigned char*>(compressed.data()), compressed.size(),
+        kMaxHeaderSize, header);
+    return parseHeader(header, type, size);
+}
+
+int readObject(void** out, size_t* len, git_object_t* type, git_odb_backend* backend,
+               const git_oid* oid) {
+    try {
+        std::string compressed;
+        if (!readFile(self(backend)->objectPath(oid), compressed)) {
+            return GIT_ENOTFOUND;
+        }
+
+        size_t size       = 0;
+        size_t headerSize = readHeader(self(backend), compressed, type, &size);
+
+        std::string inflated;
+        self(backend)->compression->decompress(
+            reinterpret_cast<const unsigned char*>(compressed.data()), compressed.size(),
+            headerSize + size, inflated);
+        if (inflated.size() != headerSize + size) {
+            throw std::runtime_error("Loose object size does not match its header.");
+        }
+
+        char* buffer = static_cast<char*>(git_odb_backend_data_alloc(backend, size + 1));
+        if (!buffer) {
+            return GIT_ERROR;
+        }
+        std::memcpy(buffer, inflated.data() + headerSize, size);
+        buffer[size] = '\0';
+
+        *out = buffer;
+        *len = size;
+        return 0;
+    } catch (const std::exception& e) {
+        return reportError(e);
+    }
+}
+
+int readObjectHeader(size_t* len, git_object_t* type, git_odb_backend* backend,
+                     const git_oid* oid) {
+    try {
+        std::string compressed;
+        if (!readFile(self(backend)->objectPath(oid), compressed)) {
+            return GIT_ENOTFOUND;
+        }
+        readHeader(self(backend), compressed, type, len);
+        return 0;
+    } catch (const std::exception& e) {
+        return reportError(e);
+    }
+}
+
+// trazi jedinstven loose objekat ciji hex pocinje datim prefiksom
+int findPrefix(git_oid* out, git_odb_backend* backend, const git_oid* shortId, size_t length) {
+    char hex[GIT_OID_HEXSZ + 1] = {};
+    git_oid_fmt(hex, shortId);
+    if (length < 2 || length > GIT_OID_HEXSZ) {
+        return GIT_ENOTFOUND;
+    }
+
+    std::string fanout = std::string(hex, 2);
+    std::string rest   = std::string(hex + 2, length - 2);
+
+    DIR* dir = opendir((self(backend)->directory + fanout).c_str());
+    if (!dir) {
+        return GIT_ENOTFOUND;
+    }
+
+    int found = 0;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() != GIT_OID_HEXSZ - 2 || name.compare(0, rest.size(), rest) != 0) {
+            continue;
+        }
+        if (++found > 1) {
+            break;
+        }
+        git_oid_fromstr(out, (fanout + name).c_str());
+    }
+    closedir(dir);
+
+    if (found > 1) {
+        git_error_set_str(GIT_ERROR_ODB, "Ambiguous loose object prefix.");
+        return GIT_EAMBIGUOUS;
+    }
+    return found ? 0 : GIT_ENOTFOUND;
+}
+
+int readObjectPrefix(git_oid* outId, void** out, size_t* len, git_object_t* type,
+                     git_odb_backend* backend, const git_oid* shortId, size_t length) {
+    git_oid id;
+    int error = length >= GIT_OID_HEXSZ ? (git_oid_cpy(&id, shortId), 0)
+                                        : findPrefix(&id, backend, shortId, length);
+    if (error != 0) {
+        return error;
+    }
+
+    error = readObject(out, len, type, backend, &id);
+    if (error == 0) {
+        git_oid_cpy(outId, &id);
+    }
+    return error;
+}
+
+int existsObject(git_odb_backend* backend, const git_oid* oid) {
+    return access(self(backend)->objectPath(oid).c_str(), F_OK) == 0;
+}
+
+int existsObjectPrefix(git_oid* out, git_odb_backend* backend, const git_oid* shortId,
+                       size_t length) {
+    return findPrefix(out, backend, shortId, length);
+}
+
+int writeObject(git_odb_backend* backend, const git_oid* oid, const void* data, size_t len,
+                git_object_t type) {
+    try {
+        std::string path = self(backend)->objectPath(oid);
+        if (access(path.c_str(), F_OK) == 0) {
+            return 0;
+        }
+
+        std::string raw = std::string(git_object_type2string(type)) + " " + std::to_string(len);
+        raw.push_back('\0');
+        raw.append(static_cast<const char*>(data), len);
+
+        std::string compressed;
+        self(backend)->compression->compress(reinterpret_cast<const unsigned char*>(raw.data()),
+                                             raw.size(), self(backend)->level, compressed);
+
+        std::string directory = path.substr(0, path.rfind('/'));
+        if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST) {
+            throw std::runtime_error("Failed to create " + directory + ": " + std::strerror(errno));
+        }
+
+        // pisemo u privremeni fajl pa ga preimenujemo, da citaoci nikad ne vide pola objekta
+        std::string temp = directory + "/tmp_obj_XXXXXX";
+        int fd           = mkstemp(&temp[0]);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create temporary object: " +
+                                     std::string(std::strerror(errno)));
+        }
+
+        size_t done = 0;
+        while (done < compressed.size()) {
+            ssize_t n = ::write(fd, compressed.data() + done, compressed.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                ::close(fd);
+                unlink(temp.c_str());
+                throw std::runtime_error("Failed to write " + temp);
+            }
+            done += static_cast<size_t>(n);
+        }
+
+        fchmod(fd, 0444);
+        ::close(fd);
+        if (rename(temp.c_str(), path.c_str()) != 0) {
+            unlink(temp.c_str());
+            throw std::runtime_error("Failed to move object into place: " + path);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        return reportError(e);
+    }
+}
+
+int foreachObject(git_odb_backend* backend, git_odb_foreach_cb cb, void* payload) {
+    static const char digits[] = "0123456789abcdef";
+
+    for (int i = 0; i < 256; ++i) {
+        std::string fanout = {digits[i >> 4], digits[i & 15]};
+        DIR* dir           = opendir((self(backend)->directory + fanout).c_str());
+        if (!dir) {
+            continue;
+        }
+
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            git_oid oid;
+            if (name.size() != GIT_OID_HEXSZ - 2 ||
+                git_oid_fromstr(&oid, (fanout + name).c_str()) != 0) {
+                continue;
+            }
+            int error = cb(&oid, payload);
+            if (error != 0) {
+                closedir(dir);
+                return error;
+            }
+        }
+        closedir(dir);
+    }
+
+    return 0;
+}
+
+int refreshObjects(git_odb_backend*) {
+    return 0;
+}
+
+int freshenObject(git_odb_backend* backend, const git_oid* oid) {
+    return utime(self(backend)->objectPath(oid).c_str(), nullptr) == 0 ? 0 : GIT_ENOTFOUND;
+}
+
+void freeBackend(git_odb_backend* backend) {
+    delete self(backend);
+}
+
+int configuredLevel(git_repository* repo) {
+    git_config* config = nullptr;
+    if (git_repository_config_snapshot(&config, repo) != 0) {
+        return git::CompressionBackend::kDefaultLevel;
+    }
+
+    int32_t level = git::CompressionBackend::kDefaultLevel;
+    if (git_config_get_int32(&level, config, "core.loosecompression") != 0 &&
+        git_config_get_int32(&level, config, "core.compression") != 0) {
+        level = git::CompressionBackend::kDefaultLevel;
+    }
+    git_config_free(config);
+
+    // -1 je zlib podrazumevani nivo
+    return level < 0 ? 6 : level;
+}
+
+}
+
+git_odb_backend* git::LooseObjectBackend::create(const std::string& objectsDirectory,
+                                                 std::unique_ptr<CompressionBackend> compression,
+                                                 int level) {
+    if (!compression) {
+        throw std::invalid_argument("Compression backend is null.");
+    }
+
+    std::unique_ptr<LooseBackend> backend(new LooseBackend());
+    if (git_odb_init_backend(backend.get(), GIT_ODB_BACKEND_VERSION) != 0) {
+        throw std::runtime_error("Failed to initialize odb backend.");
+    }
+
+    backend->directory = objectsDirectory;
+    if (backend->directory.empty() || backend->directory.back() != '/') {
+        backend->directory.push_back('/');
+    }
+    backend->compression = std::move(compression);
+    backend->level       = level;
+
+    backend->read          = readObject;
+    backend->read_prefix   = readObjectPrefix;
+    backend->read_header   = readObjectHeader;
+    backend->write         = writeObject;
+    backend->exists        = existsObject;
+    backend->exists_prefix = existsObjectPrefix;
+    backend->refresh       = refreshObjects;
+    backend->foreach       = foreachObject;
+    backend->freshen       = freshenObject;
+    backend->free          = freeBackend;
+
+    return backend.release();
+}
+
+void git::LooseObjectBackend::install(Repository* repo,
+                                      std::unique_ptr<CompressionBackend> compression) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    // ODB repozitorijuma se ne zamenjuje: ugradjeni pack backend, alternates i ranije
+    // dodati backend-i ostaju, a nas loose backend se samo dodaje ispred ugradjenog
+    git_odb* odb = nullptr;
+    if (git_repository_odb(&odb, repo->_repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_odb_backend* loose =
+        create(getObjectsDirectory(repo), std::move(compression), configuredLevel(repo->_repo));
+    if (git_odb_add_backend(odb, loose, kLoosePriority) != 0) {
+        loose->free(loose);
+        git_odb_free(odb);
+        throw std::runtime_error("Failed to add loose backend: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_odb_free(odb);
+}
+
+std::string git::LooseObjectBackend::getObjectsDirectory(Repository* repo) {
+    return std::string(git_repository_commondir(repo->_repo)) + "objects/";
+}
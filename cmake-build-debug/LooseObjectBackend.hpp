@@ -0,0 +1,34 @@
+#ifndef PROBA_LOOSEOBJECTBACKEND_HPP
+#define PROBA_LOOSEOBJECTBACKEND_HPP
+
+#include <git2.h>
+#include <git2/sys/odb_backend.h>
+
+#include <memory>
+#include <string>
+
+namespace git {
+
+class CompressionBackend;
+class Repository;
+
+// loose objekti citani i pisani preko izabranog CompressionBackend-a umesto ugradjenog zlib-a
+class LooseObjectBackend {
+public:
+    // ugradjeni loose backend ima prioritet 1; vise od toga znaci da upis i citanje loose
+    // objekata idu preko nas, a ugradjeni ostaje samo kao rezerva
+    static constexpr int kLoosePriority = 2;
+
+    // dodaje loose backend u postojeci ODB repozitorijuma; packovi i alternates ostaju
+    static void install(Repository* repo, std::unique_ptr<CompressionBackend> compression);
+
+    static git_odb_backend* create(const std::string& objectsDirectory,
+                                   std::unique_ptr<CompressionBackend> compression,
+                                   int level);
+
+    static std::string getObjectsDirectory(Repository* repo);
+};
+
+}
+
+#endif
@@ -0,0 +1,478 @@
+#include "MergeBase.hpp"
+
+#include "Branch.hpp"
+#include "CommitGraph.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Queued {
+    uint32_t generation;
+    int64_t time;
+    git_oid oid;
+
+    bool operator<(const Queued& other) const {
+        if (generation != other.generation) {
+            return generation < other.generation;
+        }
+        if (time != other.time) {
+            return time < other.time;
+        }
+        return std::memcmp(oid.id, other.oid.id, GIT_OID_RAWSZ) < 0;
+    }
+};
+
+struct ConflictEntry {
+    bool present = false;
+    git_index_entry entry;
+    std::string path;
+};
+
+struct Conflict {
+    ConflictEntry ancestor;
+    ConflictEntry ours;
+    ConflictEntry theirs;
+};
+
+// kopija unosa konflikta, jer uklanjanje konflikta oslobadja originale
+void copyEntry(const git_index_entry* source, ConflictEntry& out) {
+    if (!source) {
+        return;
+    }
+    out.present    = true;
+    out.entry      = *source;
+    out.path       = source->path;
+    out.entry.path = nullptr;
+}
+
+const git_index_entry* entryOf(ConflictEntry& conflict) {
+    if (!conflict.present) {
+        return nullptr;
+    }
+    conflict.entry.path = conflict.path.c_str();
+    return &conflict.entry;
+}
+
+void freeTrees(git_tree* a, git_tree* b, git_tree* c) {
+    git_tree_free(a);
+    git_tree_free(b);
+    git_tree_free(c);
+}
+
+}
+
+size_t git::MergeBase::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::MergeBase::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+bool git::MergeBase::OidLess::operator()(const std::vector<git_oid>& a,
+                                         const std::vector<git_oid>& b) const {
+    return std::lexicographical_compare(
+        a.begin(), a.end(), b.begin(), b.end(), [](const git_oid& x, const git_oid& y) {
+            return std::memcmp(x.id, y.id, GIT_OID_RAWSZ) < 0;
+        });
+}
+
+git::MergeBase::MergeBase(git_repository* repo) : _repo(repo) {}
+
+git::MergeBase::~MergeBase() = default;
+
+std::unique_ptr<git::MergeBase> git::MergeBase::create(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    return create(repo->_repo);
+}
+
+std::unique_ptr<git::MergeBase> git::MergeBase::create(git_repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    std::unique_ptr<MergeBase> base(new MergeBase(repo));
+    base->_graph = CommitGraph::open(repo);
+    return base;
+}
+
+size_t git::MergeBase::getVirtualBaseCount() const {
+    return _virtualTrees.size();
+}
+
+const git::MergeBase::Node& git::MergeBase::load(const git_oid* oid) {
+    auto found = _nodes.find(*oid);
+    if (found != _nodes.end()) {
+        return found->second;
+    }
+
+    Node node;
+    uint32_t position;
+    if (_graph && _graph->find(oid, &position)) {
+        node.generation = _graph->getGeneration(position);
+        node.time       = _graph->getCommitTime(position);
+        std::vector<uint32_t> parents;
+        _graph->getParents(position, parents);
+        for (uint32_t parent : parents) {
+            node.parents.push_back(_graph->getId(parent));
+        }
+    } else {
+        git_commit* commit = nullptr;
+        if (git_commit_lookup(&commit, _repo, oid) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+        node.generation = CommitGraph::kGenerationInfinity;
+        node.time       = static_cast<int64_t>(git_commit_time(commit));
+        for (unsigned int i = 0; i < git_commit_parentcount(commit); ++i) {
+            node.parents.push_back(*git_commit_parent_id(commit, i));
+        }
+        git_commit_free(commit);
+    }
+    return _nodes.emplace(*oid, std::move(node)).first->second;
+}
+
+std::vector<git_oid> git::MergeBase::findAll(const git_oid* one, const git_oid* two) {
+    return findAll(std::vector<git_oid>{*one}, std::vector<git_oid>{*two});
+}
+
+std::vector<git_oid> git::MergeBase::findAll(const std::vector<git_oid>& ones,
+                                             const std::vector<git_oid>& twos) {
+    for (const git_oid& one : ones) {
+        for (const git_oid& two : twos) {
+            if (git_oid_equal(&one, &two)) {
+                return {one};
+            }
+        }
+    }
+
+    std::vector<git_oid> result = removeRedundant(paintDown(ones, twos));
+    std::sort(result.begin(), result.end(), [this](const git_oid& a, const git_oid& b) {
+        return load(&a).time > load(&b).time;
+    });
+    return result;
+}
+
+std::vector<git_oid> git::MergeBase::paintDown(const std::vector<git_oid>& ones,
+                                               const std::vector<git_oid>& twos) {
+    std::unordered_map<git_oid, uint8_t, OidHash, OidEqual> flags;
+    std::unordered_map<git_oid, size_t, OidHash, OidEqual> queued;
+    std::priority_queue<Queued> queue;
+    // broj elemenata reda ciji commit jos nije zastareo; obilazak staje kada padne na 0
+    size_t active = 0;
+
+    auto push = [&](const git_oid& oid) {
+        const Node& node = load(&oid);
+        queue.push({node.generation, node.time, oid});
+        ++queued[oid];
+        if (!(flags[oid] & kStale)) {
+            ++active;
+        }
+    };
+
+    for (const git_oid& one : ones) {
+        flags[one] |= kParent1;
+        push(one);
+    }
+    for (const git_oid& two : twos) {
+        flags[two] |= kParent2;
+        push(two);
+    }
+
+    std::vector<git_oid> results;
+    while (active > 0) {
+        git_oid oid = queue.top().oid;
+        queue.pop();
+        --queued[oid];
+        uint8_t& own = flags[oid];
+        if (!(own & kStale)) {
+            --active;
+        }
+
+        uint8_t paint = own & (kParent1 | kParent2 | kStale);
+        if (paint == (kParent1 | kParent2)) {
+            if (!(own & kResult)) {
+                own |= kResult;
+                results.push_back(oid);
+            }
+            paint |= kStale;
+        }
+
+        // generacija roditelja je manja, pa red ostaje uredjen bez obzira na satove
+        std::vector<git_oid> parents = load(&oid).parents;
+        for (const git_oid& parent : parents) {
+            uint8_t& current = flags[parent];
+            if ((current & paint) == paint) {
+                continue;
+            }
+            if ((paint & kStale) && !(current & kStale)) {
+                active -= queued[parent];
+            }
+            current |= paint;
+            push(parent);
+        }
+    }
+
+    // rezultat koji je kasnije dostignut iz drugog rezultata je njegov predak
+    std::vector<git_oid> candidates;
+    for (const git_oid& oid : results) {
+        if (!(flags[oid] & kStale)) {
+            candidates.push_back(oid);
+        }
+    }
+    return candidates;
+}
+
+std::vector<git_oid> git::MergeBase::removeRedundant(const std::vector<git_oid>& candidates) {
+    if (candidates.size() <= 1) {
+        return candidates;
+    }
+
+    // kandidat dostupan iz drugog kandidata ima vecu generaciju od najmanje, pa se
+    // ispod nje ne silazi; commit-i van grafa (beskonacna generacija) nemaju pretke u grafu
+    uint32_t minimum = CommitGraph::kGenerationInfinity;
+    for (const git_oid& candidate : candidates) {
+        minimum = std::min(minimum, load(&candidate).generation);
+    }
+
+    std::unordered_map<git_oid, bool, OidHash, OidEqual> reached;
+    std::vector<git_oid> stack;
+    for (const git_oid& candidate : candidates) {
+        const std::vector<git_oid>& parents = load(&candidate).parents;
+        stack.insert(stack.end(), parents.begin(), parents.end());
+    }
+    while (!stack.empty()) {
+        git_oid oid = stack.back();
+        stack.pop_back();
+        if (!reached.emplace(oid, true).second) {
+            continue;
+        }
+        const Node& node = load(&oid);
+        if (node.generation < minimum) {
+            continue;
+        }
+        stack.insert(stack.end(), node.parents.begin(), node.parents.end());
+    }
+
+    std::vector<git_oid> result;
+    for (const git_oid& candidate : candidates) {
+        if (!reached.count(candidate)) {
+            result.push_back(candidate);
+        }
+    }
+    return result;
+}
+
+git_oid git::MergeBase::commitTree(const git_oid* commit) {
+    git_commit* object = nullptr;
+    if (git_commit_lookup(&object, _repo, commit) != 0) {
+        throw std::runtime_error("Failed to lookup commit: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_oid tree = *git_commit_tree_id(object);
+    git_commit_free(object);
+    return tree;
+}
+
+git_oid git::MergeBase::emptyTree() {
+    git_treebuilder* builder = nullptr;
+    git_oid tree;
+    if (git_treebuilder_new(&builder, _repo, nullptr) != 0 ||
+        git_treebuilder_write(&tree, builder) != 0) {
+        git_treebuilder_free(builder);
+        throw std::runtime_error("Failed to write empty tree: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_treebuilder_free(builder);
+    return tree;
+}
+
+git_oid git::MergeBase::getBaseTree(const git_oid* ours, const git_oid* theirs) {
+    std::vector<git_oid> bases = findAll(ours, theirs);
+    if (bases.empty()) {
+        return emptyTree();
+    }
+    if (bases.size() == 1) {
+        return commitTree(&bases[0]);
+    }
+    return virtualTree(bases);
+}
+
+git_oid git::MergeBase::virtualTree(std::vector<git_oid> bases) {
+    std::vector<git_oid> key = bases;
+    std::sort(key.begin(), key.end(), [](const git_oid& a, const git_oid& b) {
+        return std::memcmp(a.id, b.id, GIT_OID_RAWSZ) < 0;
+    });
+    auto found = _virtualTrees.find(key);
+    if (found != _virtualTrees.end()) {
+        return found->second;
+    }
+
+    // kao git recursive: baze od najstarije, svaka se spaja sa dosadasnjim rezultatom
+    std::sort(bases.begin(), bases.end(), [this](const git_oid& a, const git_oid& b) {
+        return load(&a).time < load(&b).time;
+    });
+    Side merged{{bases[0]}, commitTree(&bases[0])};
+    for (size_t i = 1; i < bases.size(); ++i) {
+        merged = mergeSides(merged, Side{{bases[i]}, commitTree(&bases[i])});
+    }
+
+    _virtualTrees.emplace(key, merged.tree);
+    return merged.tree;
+}
+
+git::MergeBase::Side git::MergeBase::mergeSides(const Side& ours, const Side& theirs) {
+    // preci virtuelne strane su preci svih commit-a koje ona predstavlja
+    std::vector<git_oid> bases = findAll(ours.commits, theirs.commits);
+    git_oid base;
+    if (bases.empty()) {
+        base = emptyTree();
+    } else if (bases.size() == 1) {
+        base = commitTree(&bases[0]);
+    } else {
+        base = virtualTree(bases);
+    }
+
+    Side merged;
+    merged.tree    = mergeTrees(&base, &ours.tree, &theirs.tree);
+    merged.commits = ours.commits;
+    merged.commits.insert(merged.commits.end(), theirs.commits.begin(), theirs.commits.end());
+    return merged;
+}
+
+git_oid git::MergeBase::mergeTrees(const git_oid* base, const git_oid* ours,
+                                   const git_oid* theirs) {
+    git_tree* baseTree  = nullptr;
+    git_tree* ourTree   = nullptr;
+    git_tree* theirTree = nullptr;
+    if (git_tree_lookup(&baseTree, _repo, base) != 0 ||
+        git_tree_lookup(&ourTree, _repo, ours) != 0 ||
+        git_tree_lookup(&theirTree, _repo, theirs) != 0) {
+        freeTrees(baseTree, ourTree, theirTree);
+        throw std::runtime_error("Failed to lookup tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_index* index = nullptr;
+    if (git_merge_trees(&index, _repo, baseTree, ourTree, theirTree, nullptr) != 0) {
+        freeTrees(baseTree, ourTree, theirTree);
+        throw std::runtime_error("Failed to merge trees: " +
+                                 std::string(git_error_last()->message));
+    }
+    freeTrees(baseTree, ourTree, theirTree);
+
+    // konflikti u virtuelnoj bazi ostaju kao sadrzaj sa markerima (kao u git recursive),
+    // a kada jedna strana fajl brise, zadrzava se verzija iz pretka, odnosno putanja se
+    // uklanja ako je nema u pretku (handle_change_delete za call_depth > 0)
+    std::vector<Conflict> conflicts;
+    git_index_conflict_iterator* iterator = nullptr;
+    if (git_index_conflict_iterator_new(&iterator, index) != 0) {
+        git_index_free(index);
+        throw std::runtime_error("Failed to create conflict iterator: " +
+                                 std::string(git_error_last()->message));
+    }
+    const git_index_entry* ancestor = nullptr;
+    const git_index_entry* our      = nullptr;
+    const git_index_entry* their    = nullptr;
+    while (git_index_conflict_next(&ancestor, &our, &their, iterator) == 0) {
+        conflicts.emplace_back();
+        copyEntry(ancestor, conflicts.back().ancestor);
+        copyEntry(our, conflicts.back().ours);
+        copyEntry(their, conflicts.back().theirs);
+    }
+    git_index_conflict_iterator_free(iterator);
+
+    for (auto& conflict : conflicts) {
+        const git_index_entry* ancestorEntry = entryOf(conflict.ancestor);
+        const git_index_entry* ourEntry      = entryOf(conflict.ours);
+        const git_index_entry* theirEntry    = entryOf(conflict.theirs);
+        const git_index_entry* kept          = ancestorEntry;
+        if (ourEntry && theirEntry) {
+            kept = ourEntry;
+        }
+        const git_index_entry* named = ourEntry ? ourEntry : theirEntry;
+        std::string path             = named ? named->path : ancestorEntry->path;
+        if (git_index_conflict_remove(index, path.c_str()) != 0) {
+            git_index_free(index);
+            throw std::runtime_error("Failed to resolve conflict in " + path + ": " +
+                                     std::string(git_error_last()->message));
+        }
+        if (!kept) {
+            continue;
+        }
+
+        git_index_entry resolved;
+        std::memset(&resolved, 0, sizeof(resolved));
+        resolved.path = path.c_str();
+        resolved.mode = kept->mode;
+        resolved.id   = kept->id;
+
+        if (ourEntry && theirEntry) {
+            git_merge_file_result result;
+            if (git_merge_file_from_index(&result, _repo, ancestorEntry, ourEntry,
+                                          theirEntry, nullptr) != 0) {
+                git_index_free(index);
+                throw std::runtime_error("Failed to merge file " + path + ": " +
+                                         std::string(git_error_last()->message));
+            }
+            int error = git_blob_create_from_buffer(&resolved.id, _repo, result.ptr, result.len);
+            if (result.mode) {
+                resolved.mode = result.mode;
+            }
+            git_merge_file_result_free(&result);
+            if (error != 0) {
+                git_index_free(index);
+                throw std::runtime_error("Failed to write merged blob: " +
+                                         std::string(git_error_last()->message));
+            }
+        }
+
+        if (git_index_add(index, &resolved) != 0) {
+            git_index_free(index);
+            throw std::runtime_error("Failed to resolve conflict in " + path + ": " +
+                                     std::string(git_error_last()->message));
+        }
+    }
+
+    git_oid tree;
+    if (git_index_write_tree_to(&tree, index, _repo) != 0) {
+        git_index_free(index);
+        throw std::runtime_error("Failed to write virtual base tree: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_index_free(index);
+    return tree;
+}
+
+git_index* git::MergeBase::merge(const git_oid* ours, const git_oid* theirs,
+                                 const git_merge_options* options) {
+    git_oid base      = getBaseTree(ours, theirs);
+    git_oid ourTree   = commitTree(ours);
+    git_oid theirTree = commitTree(theirs);
+
+    git_tree* trees[3] = {nullptr, nullptr, nullptr};
+    if (git_tree_lookup(&trees[0], _repo, &base) != 0 ||
+        git_tree_lookup(&trees[1], _repo, &ourTree) != 0 ||
+        git_tree_lookup(&trees[2], _repo, &theirTree) != 0) {
+        freeTrees(trees[0], trees[1], trees[2]);
+        throw std::runtime_error("Failed to lookup tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_index* index = nullptr;
+    int error        = git_merge_trees(&index, _repo, trees[0], trees[1], trees[2], options);
+    freeTrees(trees[0], trees[1], trees[2]);
+    if (error != 0) {
+        throw std::runtime_error("Failed to merge trees: " +
+                                 std::string(git_error_last()->message));
+    }
+    return index;
+}
@@ -0,0 +1,96 @@
+#ifndef PROBA_MERGEBASE_HPP
+#define PROBA_MERGEBASE_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace git {
+
+class CommitGraph;
+class Repository;
+
+// merge-base za istorije sa unakrsnim merge-ovima: paint-down obilazak u redosledu
+// generacija (iz commit-graph-a) staje cim u redu ostanu samo zajednicki preci, a
+// suvisne baze se uklanjaju obilaskom koji ne silazi ispod najmanje generacije kandidata;
+// vise baza se spaja u virtuelnu bazu (kao git recursive) preko merge-a stabala u
+// memoriji, a gotova virtuelna stabla se pamte i ponovo koriste
+class MergeBase {
+public:
+    MergeBase(const MergeBase&)            = delete;
+    MergeBase& operator=(const MergeBase&) = delete;
+    ~MergeBase();
+
+    static std::unique_ptr<MergeBase> create(Repository* repo);
+    static std::unique_ptr<MergeBase> create(git_repository* repo);
+
+    // sve najbolje zajednicke baze, najnovija prva
+    std::vector<git_oid> findAll(const git_oid* one, const git_oid* two);
+    std::vector<git_oid> findAll(const std::vector<git_oid>& ones,
+                                 const std::vector<git_oid>& twos);
+
+    // stablo koje sluzi kao predak: stablo jedine baze, virtuelno stablo za vise baza,
+    // odnosno prazno stablo kada istorije nemaju zajednickog pretka
+    git_oid getBaseTree(const git_oid* ours, const git_oid* theirs);
+
+    // merge dva commit-a u indeks u memoriji (kao git_merge_commits); oslobadja pozivalac
+    git_index* merge(const git_oid* ours, const git_oid* theirs,
+                     const git_merge_options* options = nullptr);
+
+    size_t getVirtualBaseCount() const;
+
+private:
+    static constexpr uint8_t kParent1 = 1;
+    static constexpr uint8_t kParent2 = 2;
+    static constexpr uint8_t kStale   = 4;
+    static constexpr uint8_t kResult  = 8;
+
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+    struct OidLess {
+        bool operator()(const std::vector<git_oid>& a, const std::vector<git_oid>& b) const;
+    };
+
+    struct Node {
+        uint32_t generation = 0;
+        int64_t time        = 0;
+        std::vector<git_oid> parents;
+    };
+
+    // strana merge-a: pravi commit-i koje predstavlja i njeno stablo
+    struct Side {
+        std::vector<git_oid> commits;
+        git_oid tree;
+    };
+
+    explicit MergeBase(git_repository* repo);
+
+    const Node& load(const git_oid* oid);
+    std::vector<git_oid> paintDown(const std::vector<git_oid>& ones,
+                                   const std::vector<git_oid>& twos);
+    std::vector<git_oid> removeRedundant(const std::vector<git_oid>& candidates);
+
+    git_oid commitTree(const git_oid* commit);
+    git_oid emptyTree();
+    git_oid virtualTree(std::vector<git_oid> bases);
+    Side mergeSides(const Side& ours, const Side& theirs);
+    git_oid mergeTrees(const git_oid* base, const git_oid* ours, const git_oid* theirs);
+
+    git_repository* _repo;
+    std::unique_ptr<CommitGraph> _graph;
+    std::unordered_map<git_oid, Node, OidHash, OidEqual> _nodes;
+    std::map<std::vector<git_oid>, git_oid, OidLess> _virtualTrees;
+};
+
+}
+
+#endif
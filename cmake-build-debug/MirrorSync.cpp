@@ -0,0 +1,340 @@
+#include "MirrorSync.hpp"
+
+#include "Branch.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+struct PackStream {
+    git_odb_writepack* writepack;
+    git_indexer_progress stats;
+    size_t bytes;
+};
+
+int appendToPack(void* data, size_t size, void* payload) {
+    auto stream = static_cast<PackStream*>(payload);
+    stream->bytes += size;
+    return stream->writepack->append(stream->writepack, data, size, &stream->stats);
+}
+
+bool sameState(const git::MirrorSync::RefState& a, const git::MirrorSync::RefState& b) {
+    if (a.symbolic != b.symbolic) {
+        return false;
+    }
+    return a.symbolic ? a.symbolicTarget == b.symbolicTarget : git_oid_equal(&a.id, &b.id);
+}
+
+git_odb* openOdb(git_repository* repo) {
+    git_odb* odb = nullptr;
+    if (git_repository_odb(&odb, repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return odb;
+}
+
+// dodaje objekat u setnju ili direktno u pack, u zavisnosti od tipa; kod taga na tag ide
+// ceo lanac tagova, a setnja pocinje od objekta na kraju lanca
+void addWant(git_repository* repo, git_packbuilder* builder, git_revwalk* walk,
+             const std::string& name, const git_oid* id) {
+    git_object* object = nullptr;
+    if (git_object_lookup(&object, repo, id, GIT_OBJECT_ANY) != 0) {
+        throw std::runtime_error("Failed to lookup " + name + ": " +
+                                 std::string(git_error_last()->message));
+    }
+
+    int error = 0;
+    while (error == 0 && git_object_type(object) == GIT_OBJECT_TAG) {
+        error = git_packbuilder_insert(builder, git_object_id(object), name.c_str());
+
+        git_object* target = nullptr;
+        if (error == 0) {
+            error = git_tag_target(&target, reinterpret_cast<git_tag*>(object));
+        }
+        git_object_free(object);
+        object = target;
+    }
+
+    if (error == 0 && git_object_type(object) == GIT_OBJECT_COMMIT) {
+        error = git_revwalk_push(walk, git_object_id(object));
+    } else if (error == 0) {
+        error = git_packbuilder_insert_recur(builder, git_object_id(object), name.c_str());
+    }
+    git_object_free(object);
+
+    if (error != 0) {
+        throw std::runtime_error("Failed to add " + name + " to pack: " +
+                                 std::string(git_error_last()->message));
+    }
+}
+
+// stanje reference u targetu; nepostojeca referenca je nula OID, kao oldState nove reference
+bool readRefState(git_repository* repo, const std::string& name,
+                  git::MirrorSync::RefState* state) {
+    *state             = git::MirrorSync::RefState();
+    git_reference* ref = nullptr;
+    int error          = git_reference_lookup(&ref, repo, name.c_str());
+    if (error == GIT_ENOTFOUND) {
+        return true;
+    }
+    if (error != 0) {
+        return false;
+    }
+
+    if (git_reference_type(ref) == GIT_REFERENCE_SYMBOLIC) {
+        state->symbolic       = true;
+        state->symbolicTarget = git_reference_symbolic_target(ref);
+    } else {
+        state->id = *git_reference_target(ref);
+    }
+    git_reference_free(ref);
+    return true;
+}
+
+}
+
+git::MirrorSync::MirrorSync(Repository* source, Repository* target, bool prune)
+    : _source(source), _target(target), _prune(prune) {}
+
+std::unique_ptr<git::MirrorSync> git::MirrorSync::create(Repository* source, Repository* target,
+                                                         bool prune) {
+    if (!source || !target) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (source == target) {
+        throw std::invalid_argument("Source and target repository are the same.");
+    }
+
+    return std::unique_ptr<MirrorSync>(new MirrorSync(source, target, prune));
+}
+
+std::map<std::string, git::MirrorSync::RefState> git::MirrorSync::readRefs(Repository* repo) {
+    std::map<std::string, RefState> refs;
+
+    git_reference_iterator* iterator = nullptr;
+    if (git_reference_iterator_new(&iterator, repo->_repo) != 0) {
+        throw std::runtime_error("Failed to create reference iterator: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_reference* ref = nullptr;
+    while (git_reference_next(&ref, iterator) == 0) {
+        RefState state;
+        if (git_reference_type(ref) == GIT_REFERENCE_SYMBOLIC) {
+            state.symbolic       = true;
+            state.symbolicTarget = git_reference_symbolic_target(ref);
+        } else {
+            state.id = *git_reference_target(ref);
+        }
+        refs[git_reference_name(ref)] = state;
+        git_reference_free(ref);
+    }
+
+    git_reference_iterator_free(iterator);
+    return refs;
+}
+
+const std::vector<git::MirrorSync::RefUpdate>& git::MirrorSync::plan() {
+    auto sourceRefs = readRefs(_source);
+    auto targetRefs = readRefs(_target);
+
+    _updates.clear();
+    _haves.clear();
+
+    for (const auto& entry : sourceRefs) {
+        auto existing = targetRefs.find(entry.first);
+        if (existing != targetRefs.end() && sameState(existing->second, entry.second)) {
+            continue;
+        }
+
+        RefUpdate update;
+        update.name     = entry.first;
+        update.newState = entry.second;
+        if (existing != targetRefs.end()) {
+            update.oldState = existing->second;
+        }
+        _updates.push_back(update);
+    }
+
+    if (_prune) {
+        for (const auto& entry : targetRefs) {
+            if (sourceRefs.count(entry.first)) {
+                continue;
+            }
+            RefUpdate update;
+            update.name     = entry.first;
+            update.deleted  = true;
+            update.oldState = entry.second;
+            _updates.push_back(update);
+        }
+    }
+
+    // sta target vec ima: setnju ogranicavaju samo commit-i koje i izvor poznaje
+    git_odb* sourceOdb = openOdb(_source->_repo);
+    for (const auto& entry : targetRefs) {
+        size_t size       = 0;
+        git_object_t type = GIT_OBJECT_INVALID;
+        if (!entry.second.symbolic &&
+            git_odb_read_header(&size, &type, sourceOdb, &entry.second.id) == 0 &&
+            type == GIT_OBJECT_COMMIT) {
+            _haves.push_back(entry.second.id);
+        }
+    }
+    git_odb_free(sourceOdb);
+
+    _planned = true;
+    return _updates;
+}
+
+void git::MirrorSync::run() {
+    if (!_planned) {
+        plan();
+    }
+
+    transferObjects();
+    applyRefUpdates();
+    _planned = false;
+}
+
+void git::MirrorSync::transferObjects() {
+    git_odb* targetOdb = openOdb(_target->_repo);
+
+    std::vector<const RefUpdate*> wants;
+    for (const RefUpdate& update : _updates) {
+        if (!update.deleted && !update.newState.symbolic &&
+            !git_odb_exists(targetOdb, &update.newState.id)) {
+            wants.push_back(&update);
+        }
+    }
+    if (wants.empty()) {
+        git_odb_free(targetOdb);
+        return;
+    }
+
+    git_packbuilder* builder = nullptr;
+    git_revwalk* walk        = nullptr;
+    if (git_packbuilder_new(&builder, _source->_repo) != 0 ||
+        git_revwalk_new(&walk, _source->_repo) != 0) {
+        git_packbuilder_free(builder);
+        git_odb_free(targetOdb);
+        throw std::runtime_error("Failed to prepare pack: " +
+                                 std::string(git_error_last()->message));
+    }
+    git_packbuilder_set_threads(builder, 0);
+
+    try {
+        for (const RefUpdate* update : wants) {
+            addWant(_source->_repo, builder, walk, update->name, &update->newState.id);
+        }
+        int error = 0;
+        for (size_t i = 0; error == 0 && i < _haves.size(); ++i) {
+            error = git_revwalk_hide(walk, &_haves[i]);
+        }
+        if (error != 0 || git_packbuilder_insert_walk(builder, walk) != 0) {
+            throw std::runtime_error("Failed to collect missing objects: " +
+                                     std::string(git_error_last()->message));
+        }
+    } catch (...) {
+        git_revwalk_free(walk);
+        git_packbuilder_free(builder);
+        git_odb_free(targetOdb);
+        throw;
+    }
+    git_revwalk_free(walk);
+
+    _transferredObjects = git_packbuilder_object_count(builder);
+    _transferredBytes   = 0;
+    if (_transferredObjects == 0) {
+        git_packbuilder_free(builder);
+        git_odb_free(targetOdb);
+        return;
+    }
+
+    // pack ide direktno u indexer targeta, bez privremenog fajla
+    PackStream stream = {};
+    if (git_odb_write_pack(&stream.writepack, targetOdb, nullptr, nullptr) != 0) {
+        git_packbuilder_free(builder);
+        git_odb_free(targetOdb);
+        throw std::runtime_error("Failed to open pack writer: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    int error = git_packbuilder_foreach(builder, appendToPack, &stream);
+    if (error == 0) {
+        error = stream.writepack->commit(stream.writepack, &stream.stats);
+    }
+    stream.writepack->free(stream.writepack);
+    git_packbuilder_free(builder);
+    git_odb_free(targetOdb);
+
+    if (error != 0) {
+        throw std::runtime_error("Failed to transfer objects: " +
+                                 std::string(git_error_last()->message));
+    }
+    _transferredBytes = stream.bytes;
+}
+
+void git::MirrorSync::applyRefUpdates() {
+    if (_updates.empty()) {
+        return;
+    }
+
+    git_transaction* transaction = nullptr;
+    if (git_transaction_new(&transaction, _target->_repo) != 0) {
+        throw std::runtime_error("Failed to start reference transaction: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    const char* message = "mirror sync";
+    int error           = 0;
+    for (size_t i = 0; error == 0 && i < _updates.size(); ++i) {
+        error = git_transaction_lock_ref(transaction, _updates[i].name.c_str());
+    }
+
+    // compare-and-swap: posle zakljucavanja svaka referenca mora biti kakva je bila u
+    // plan(); izmena izmedju plan() i run() prekida celu transakciju, a run() planira iznova
+    for (size_t i = 0; error == 0 && i < _updates.size(); ++i) {
+        const RefUpdate& update = _updates[i];
+        RefState current;
+        if (!readRefState(_target->_repo, update.name, &current)) {
+            error = -1;
+        } else if (!sameState(current, update.oldState)) {
+            git_transaction_free(transaction);
+            _planned = false;
+            throw std::runtime_error("Reference " + update.name +
+                                     " changed since the sync was planned.");
+        }
+    }
+    for (size_t i = 0; error == 0 && i < _updates.size(); ++i) {
+        const RefUpdate& update = _updates[i];
+        if (update.deleted) {
+            error = git_transaction_remove(transaction, update.name.c_str());
+        } else if (update.newState.symbolic) {
+            error = git_transaction_set_symbolic_target(transaction, update.name.c_str(),
+                                                        update.newState.symbolicTarget.c_str(),
+                                                        nullptr, message);
+        } else {
+            error = git_transaction_set_target(transaction, update.name.c_str(),
+                                               &update.newState.id, nullptr, message);
+        }
+    }
+    if (error == 0) {
+        error = git_transaction_commit(transaction);
+    }
+    git_transaction_free(transaction);
+
+    if (error != 0) {
+        throw std::runtime_error("Failed to update references: " +
+                                 std::string(git_error_last()->message));
+    }
+}
+
+size_t git::MirrorSync::getTransferredObjectCount() const {
+    return _transferredObjects;
+}
+
+size_t git::MirrorSync::getTransferredBytes() const {
+    return _transferredBytes;
+}
@@ -0,0 +1,69 @@
+#ifndef PROBA_MIRRORSYNC_HPP
+#define PROBA_MIRRORSYNC_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// sinhronizacija lokalnog mirror-a: razlika referenci, jedan pack sa objektima koji
+// nedostaju i sve izmene referenci u jednoj transakciji
+class MirrorSync {
+public:
+    struct RefState {
+        bool symbolic = false;
+        git_oid id    = {};
+        std::string symbolicTarget;
+    };
+
+    struct RefUpdate {
+        std::string name;
+        bool deleted = false;
+        RefState oldState;
+        RefState newState;
+    };
+
+    MirrorSync(const MirrorSync&)            = delete;
+    MirrorSync& operator=(const MirrorSync&) = delete;
+
+    static std::unique_ptr<MirrorSync> create(Repository* source, Repository* target,
+                                              bool prune = true);
+
+    static std::map<std::string, RefState> readRefs(Repository* repo);
+
+    const std::vector<RefUpdate>& plan();
+    // reference se menjaju samo ako su i dalje u oldState iz plan(); inace se baca izuzetak,
+    // nijedna referenca se ne menja, a sledeci run() planira iznova
+    void run();
+
+    size_t getTransferredObjectCount() const;
+    size_t getTransferredBytes() const;
+
+private:
+    MirrorSync(Repository* source, Repository* target, bool prune);
+
+    void transferObjects();
+    void applyRefUpdates();
+
+    Repository* _source;
+    Repository* _target;
+    bool _prune;
+
+    bool _planned = false;
+    std::vector<RefUpdate> _updates;
+    std::vector<git_oid> _haves;
+
+    size_t _transferredObjects = 0;
+    size_t _transferredBytes   = 0;
+};
+
+}
+
+#endif
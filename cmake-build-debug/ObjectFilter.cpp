@@ -0,0 +1,292 @@
+#include "ObjectFilter.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+namespace {
+
+const size_t kBlockBits  = 512;
+const size_t kBlockWords = kBlockBits / 64;
+const int kProbes        = 8;
+
+int collectOid(const git_oid* oid, void* payload) {
+    static_cast<std::vector<git_oid>*>(payload)->push_back(*oid);
+    return 0;
+}
+
+timespec modificationTime(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return timespec{};
+    }
+    return st.st_mtim;
+}
+
+bool sameTime(const timespec& a, const timespec& b) {
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+// loose objekti upisani mimo write() (git CLI, commit-i iz Branch-a) ne menjaju potpis,
+// pa se negativan odgovor filtera potvrdjuje jednim stat-om loose putanje
+bool looseExists(const std::string& objects, const git_oid* oid) {
+    char hex[GIT_OID_HEXSZ + 1] = {};
+    git_oid_fmt(hex, oid);
+    std::string path = objects + std::string(hex, 2) + "/" + (hex + 2);
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// objects direktorijumi iz info/alternates, rekurzivno kao u libgit2 (najvise 5 nivoa);
+// relativne putanje su relativne u odnosu na objects direktorijum koji ih navodi
+void collectAlternates(const std::string& objects, std::vector<std::string>& out, int depth) {
+    if (depth > 5) {
+        return;
+    }
+
+    std::ifstream file(objects + "info/alternates");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::string directory = line[0] == '/' ? line : objects + line;
+        if (directory.back() != '/') {
+            directory += '/';
+        }
+        if (std::find(out.begin(), out.end(), directory) == out.end()) {
+            out.push_back(directory);
+            collectAlternates(directory, out, depth + 1);
+        }
+    }
+}
+
+git_odb* openOdb(git_repository* repo) {
+    git_odb* odb = nullptr;
+    if (git_repository_odb(&odb, repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return odb;
+}
+
+}
+
+struct git::ObjectFilter::Table {
+    size_t blockMask = 0;
+    size_t capacity  = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    std::atomic<size_t> count{0};
+
+    // objects direktorijumi (sopstveni pa alternates) i mtime njihovih pack direktorijuma
+    // u trenutku rebuild-a
+    std::vector<std::string> directories;
+    std::vector<timespec> packTimes;
+};
+
+git::ObjectFilter::ObjectFilter(Repository* repo) : _repo(repo) {}
+
+std::unique_ptr<git::ObjectFilter> git::ObjectFilter::create(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::unique_ptr<ObjectFilter> filter(new ObjectFilter(repo));
+    filter->rebuild();
+    return filter;
+}
+
+std::shared_ptr<git::ObjectFilter::Table> git::ObjectFilter::createTable(size_t capacity) {
+    size_t minCapacity = kMinCapacity;
+    capacity           = std::max(capacity, minCapacity);
+
+    size_t blocks = 1;
+    while (blocks * kBlockBits < capacity * kBitsPerObject) {
+        blocks <<= 1;
+    }
+
+    auto table       = std::make_shared<Table>();
+    table->blockMask = blocks - 1;
+    table->capacity  = capacity;
+    table->words.reset(new std::atomic<uint64_t>[blocks * kBlockWords]);
+    for (size_t i = 0; i < blocks * kBlockWords; ++i) {
+        table->words[i].store(0, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+// OID je vec kriptografski hes, pa se njegovi bajtovi koriste direktno kao hesevi filtera
+void git::ObjectFilter::insert(Table& table, const git_oid* oid) {
+    uint64_t block;
+    uint32_t h2, h3;
+    std::memcpy(&block, oid->id, sizeof(block));
+    std::memcpy(&h2, oid->id + 8, sizeof(h2));
+    std::memcpy(&h3, oid->id + 12, sizeof(h3));
+    h3 |= 1;
+
+    std::atomic<uint64_t>* words = &table.words[(block & table.blockMask) * kBlockWords];
+    for (int i = 0; i < kProbes; ++i) {
+        uint32_t bit = (h2 + static_cast<uint32_t>(i) * h3) >> 23;
+        words[bit >> 6].fetch_or(1ull << (bit & 63), std::memory_order_relaxed);
+    }
+    table.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool git::ObjectFilter::mayContain(const git_oid* oid) const {
+    return contains(*std::atomic_load(&_table), oid);
+}
+
+bool git::ObjectFilter::contains(const Table& table, const git_oid* oid) {
+    uint64_t block;
+    uint32_t h2, h3;
+    std::memcpy(&block, oid->id, sizeof(block));
+    std::memcpy(&h2, oid->id + 8, sizeof(h2));
+    std::memcpy(&h3, oid->id + 12, sizeof(h3));
+    h3 |= 1;
+
+    const std::atomic<uint64_t>* words = &table.words[(block & table.blockMask) * kBlockWords];
+    for (int i = 0; i < kProbes; ++i) {
+        uint32_t bit = (h2 + static_cast<uint32_t>(i) * h3) >> 23;
+        if (!(words[bit >> 6].load(std::memory_order_relaxed) & (1ull << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool git::ObjectFilter::exists(const git_oid* oid) const {
+    std::shared_ptr<Table> table = std::atomic_load(&_table);
+    if (!contains(*table, oid)) {
+        // negativan odgovor vazi samo ako objekat nije loose ni ovde ni u alternates i ako
+        // se nijedan pack direktorijum nije promenio posle rebuild-a (pack iz drugog
+        // procesa); inace odlucuje ODB
+        bool changed = false;
+        for (size_t i = 0; i < table->directories.size(); ++i) {
+            if (looseExists(table->directories[i], oid)) {
+                return true;
+            }
+            changed = changed || !sameTime(modificationTime(table->directories[i] + "pack"),
+                                           table->packTimes[i]);
+        }
+        if (!changed) {
+            _skipped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    git_odb* odb = openOdb(_repo->_repo);
+    bool found   = git_odb_exists(odb, oid) == 1;
+    git_odb_free(odb);
+    return found;
+}
+
+void git::ObjectFilter::add(const git_oid* oid) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    insert(*_table, oid);
+    // rebuild koji je u toku mozda nije video ovaj objekat, pa ga ubacujemo i u novu tabelu
+    if (_rebuilding) {
+        _pending.push_back(*oid);
+    }
+}
+
+void git::ObjectFilter::write(git_oid* out, const void* data, size_t size, git_object_t type) {
+    git_odb* odb = openOdb(_repo->_repo);
+    int error    = git_odb_write(out, odb, data, size, type);
+    git_odb_free(odb);
+    if (error != 0) {
+        throw std::runtime_error("Failed to write object: " +
+                                 std::string(git_error_last()->message));
+    }
+    add(out);
+}
+
+void git::ObjectFilter::rebuild() {
+    std::lock_guard<std::mutex> rebuildLock(_rebuildMutex);
+    Signature signature = readSignature();
+
+    // potpisi pack direktorijuma se citaju pre nabrajanja, pa pack dodat u medjuvremenu
+    // ostaje vidljiv kao promena
+    std::vector<std::string> directories = {
+        std::string(git_repository_commondir(_repo->_repo)) + "objects/"};
+    collectAlternates(directories.front(), directories, 1);
+
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _rebuilding = true;
+        _pending.clear();
+    }
+
+    std::vector<git_oid> oids;
+    git_odb* odb = nullptr;
+    int error    = git_repository_odb(&odb, _repo->_repo);
+    if (error == 0) {
+        error = git_odb_foreach(odb, collectOid, &oids);
+        git_odb_free(odb);
+    }
+    if (error != 0) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _rebuilding = false;
+        throw std::runtime_error("Failed to enumerate objects: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    // rezerva od 25% za objekte koji ce biti dodati pre sledeceg rebuild-a
+    std::shared_ptr<Table> table = createTable(oids.size() + oids.size() / 4);
+    table->directories           = directories;
+    for (const std::string& directory : directories) {
+        table->packTimes.push_back(modificationTime(directory + "pack"));
+    }
+    for (const git_oid& oid : oids) {
+        insert(*table, &oid);
+    }
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    for (const git_oid& oid : _pending) {
+        insert(*table, &oid);
+    }
+    _pending.clear();
+    _rebuilding = false;
+    std::atomic_store(&_table, table);
+    _signature = signature;
+}
+
+bool git::ObjectFilter::refresh() {
+    {
+        std::lock_guard<std::mutex> rebuildLock(_rebuildMutex);
+        Signature signature = readSignature();
+        bool overfull       = getObjectCount() > 2 * getCapacity();
+        if (!overfull && sameTime(signature.packs, _signature.packs) &&
+            sameTime(signature.alternates, _signature.alternates)) {
+            return false;
+        }
+    }
+
+    rebuild();
+    return true;
+}
+
+git::ObjectFilter::Signature git::ObjectFilter::readSignature() const {
+    std::string objects = std::string(git_repository_commondir(_repo->_repo)) + "objects/";
+
+    Signature signature;
+    signature.packs      = modificationTime(objects + "pack");
+    signature.alternates = modificationTime(objects + "info/alternates");
+    return signature;
+}
+
+size_t git::ObjectFilter::getObjectCount() const {
+    return std::atomic_load(&_table)->count.load(std::memory_order_relaxed);
+}
+
+size_t git::ObjectFilter::getCapacity() const {
+    return std::atomic_load(&_table)->capacity;
+}
+
+size_t git::ObjectFilter::getSkippedLookups() const {
+    return _skipped.load(std::memory_order_relaxed);
+}
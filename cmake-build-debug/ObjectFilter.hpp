@@ -0,0 +1,76 @@
+#ifndef PROBA_OBJECTFILTER_HPP
+#define PROBA_OBJECTFILTER_HPP
+
+#include <git2.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// blokovski Bloom filter nad svim OID-ovima u ODB-u; negativan odgovor ne otvara ODB, samo
+// proverava loose putanju u repozitorijumu i u alternates (loose objekte upisane van write()
+// filter ne vidi) i potpise pack direktorijuma; ako se neki promenio, odlucuje ODB
+class ObjectFilter {
+public:
+    static constexpr size_t kBitsPerObject = 10;
+    static constexpr size_t kMinCapacity   = 1024;
+
+    ObjectFilter(const ObjectFilter&)            = delete;
+    ObjectFilter& operator=(const ObjectFilter&) = delete;
+
+    static std::unique_ptr<ObjectFilter> create(Repository* repo);
+
+    // ponovo cita sve OID-ove iz ODB-a (posle repack-a ili fetch-a iz drugog procesa)
+    void rebuild();
+    // rebuild samo ako se pack direktorijum ili alternates promenio; vraca true ako jeste
+    bool refresh();
+
+    void add(const git_oid* oid);
+    void write(git_oid* out, const void* data, size_t size, git_object_t type);
+
+    bool mayContain(const git_oid* oid) const;
+    bool exists(const git_oid* oid) const;
+
+    size_t getObjectCount() const;
+    size_t getCapacity() const;
+    size_t getSkippedLookups() const;
+
+private:
+    struct Table;
+    struct Signature {
+        timespec packs;
+        timespec alternates;
+    };
+
+    explicit ObjectFilter(Repository* repo);
+
+    static std::shared_ptr<Table> createTable(size_t capacity);
+    static void insert(Table& table, const git_oid* oid);
+    static bool contains(const Table& table, const git_oid* oid);
+    Signature readSignature() const;
+
+    Repository* _repo;
+
+    std::shared_ptr<Table> _table;
+    Signature _signature = {};
+
+    std::mutex _rebuildMutex;
+    std::mutex _writeMutex;
+    bool _rebuilding = false;
+    std::vector<git_oid> _pending;
+
+    mutable std::atomic<size_t> _skipped{0};
+};
+
+}
+
+#endif
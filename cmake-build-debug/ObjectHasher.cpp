@@ -0,0 +1,670 @@
+#include "ObjectHasher.hpp"
+
+#include "Branch.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define GIT_HASHER_X86 1
+#endif
+
+namespace {
+
+typedef git::ObjectHasher::BlockFunction BlockFunction;
+
+const size_t kBlockSize = 64;
+
+const uint32_t kSha1Initial[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+const uint32_t kSha256Initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+const uint32_t kSha256Constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+inline uint32_t rotateLeft(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+inline uint32_t rotateRight(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t loadBigEndian(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void sha1Portable(uint32_t* state, const unsigned char* data, size_t blocks) {
+    for (; blocks > 0; --blocks, data += kBlockSize) {
+        uint32_t w[80];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = loadBigEndian(data + 4 * t);
+        }
+        for (int t = 16; t < 80; ++t) {
+            w[t] = rotateLeft(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+        for (int t = 0; t < 80; ++t) {
+            uint32_t f, k;
+            if (t < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            } else if (t < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (t < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+            uint32_t temp = rotateLeft(a, 5) + f + e + k + w[t];
+            e             = d;
+            d             = c;
+            c             = rotateLeft(b, 30);
+            b             = a;
+            a             = temp;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+void sha256Portable(uint32_t* state, const unsigned char* data, size_t blocks) {
+    for (; blocks > 0; --blocks, data += kBlockSize) {
+        uint32_t w[64];
+        for (int t = 0; t < 16; ++t) {
+            w[t] = loadBigEndian(data + 4 * t);
+        }
+        for (int t = 16; t < 64; ++t) {
+            uint32_t s0 = rotateRight(w[t - 15], 7) ^ rotateRight(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = rotateRight(w[t - 2], 17) ^ rotateRight(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t]        = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; ++t) {
+            uint32_t s1    = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            uint32_t ch    = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + ch + kSha256Constants[t] + w[t];
+            uint32_t s0    = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            uint32_t maj   = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + maj;
+            h              = g;
+            g              = f;
+            f              = e;
+            e              = d + temp1;
+            d              = c;
+            c              = b;
+            b              = a;
+            a              = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef GIT_HASHER_X86
+#define GIT_SHA_TARGET __attribute__((target("sha,sse4.1,ssse3"), always_inline)) inline
+
+// jedna grupa od 4 runde; G je redni broj grupe (0-19), poruke se rotiraju kroz msg[4]
+template <int G>
+GIT_SHA_TARGET void sha1Group(__m128i& abcd, __m128i& e0, __m128i& e1, __m128i* msg,
+                              const unsigned char* data, __m128i mask) {
+    __m128i& current = G % 2 == 0 ? e0 : e1;
+    __m128i& other   = G % 2 == 0 ? e1 : e0;
+
+    if (G < 4) {
+        msg[G] = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * G)), mask);
+    }
+    if (G == 0) {
+        current = _mm_add_epi32(current, msg[0]);
+    } else {
+        current = _mm_sha1nexte_epu32(current, msg[G % 4]);
+    }
+    other = abcd;
+    if (G >= 3 && G <= 18) {
+        msg[(G + 1) % 4] = _mm_sha1msg2_epu32(msg[(G + 1) % 4], msg[G % 4]);
+    }
+    abcd = _mm_sha1rnds4_epu32(abcd, current, G / 5);
+    if (G >= 1 && G <= 16) {
+        msg[(G + 3) % 4] = _mm_sha1msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+    }
+    if (G >= 2 && G <= 17) {
+        msg[(G + 2) % 4] = _mm_xor_si128(msg[(G + 2) % 4], msg[G % 4]);
+    }
+}
+
+template <size_t... G>
+GIT_SHA_TARGET void sha1Groups(__m128i& abcd, __m128i& e0, __m128i& e1, __m128i* msg,
+                               const unsigned char* data, __m128i mask,
+                               std::index_sequence<G...>) {
+    (void)std::initializer_list<int>{(sha1Group<G>(abcd, e0, e1, msg, data, mask), 0)...};
+}
+
+__attribute__((target("sha,sse4.1,ssse3"))) void sha1ShaNi(uint32_t* state,
+                                                          const unsigned char* data,
+                                                          size_t blocks) {
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ll, 0x08090a0b0c0d0e0fll);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)),
+                                     0x1b);
+    __m128i e0   = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; blocks > 0; --blocks, data += kBlockSize) {
+        __m128i abcdSave = abcd;
+        __m128i e0Save   = e0;
+        __m128i e1       = _mm_setzero_si128();
+        __m128i msg[4];
+
+        sha1Groups(abcd, e0, e1, msg, data, mask, std::make_index_sequence<20>());
+
+        e0   = _mm_sha1nexte_epu32(e0, e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+}
+
+template <int G>
+GIT_SHA_TARGET void sha256Group(__m128i& state0, __m128i& state1, __m128i* msg,
+                                const unsigned char* data, __m128i mask) {
+    if (G < 4) {
+        msg[G] = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * G)), mask);
+    }
+
+    __m128i words = _mm_add_epi32(
+        msg[G % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(kSha256Constants + 4 * G)));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+    if (G >= 3 && G <= 14) {
+        __m128i carry    = _mm_alignr_epi8(msg[G % 4], msg[(G + 3) % 4], 4);
+        msg[(G + 1) % 4] = _mm_add_epi32(msg[(G + 1) % 4], carry);
+        msg[(G + 1) % 4] = _mm_sha256msg2_epu32(msg[(G + 1) % 4], msg[G % 4]);
+    }
+    words  = _mm_shuffle_epi32(words, 0x0e);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, words);
+    if (G >= 1 && G <= 12) {
+        msg[(G + 3) % 4] = _mm_sha256msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+    }
+}
+
+template <size_t... G>
+GIT_SHA_TARGET void sha256Groups(__m128i& state0, __m128i& state1, __m128i* msg,
+                                 const unsigned char* data, __m128i mask,
+                                 std::index_sequence<G...>) {
+    (void)std::initializer_list<int>{(sha256Group<G>(state0, state1, msg, data, mask), 0)...};
+}
+
+__attribute__((target("sha,sse4.1,ssse3"))) void sha256ShaNi(uint32_t* state,
+                                                            const unsigned char* data,
+                                                            size_t blocks) {
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+    // SHA-NI ocekuje stanje rasporedjeno kao ABEF/CDGH
+    __m128i cdab   = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    __m128i efgh   = _mm_shuffle_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i state1 = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for (; blocks > 0; --blocks, data += kBlockSize) {
+        __m128i save0 = state0;
+        __m128i save1 = state1;
+        __m128i msg[4];
+
+        sha256Groups(state0, state1, msg, data, mask, std::make_index_sequence<16>());
+
+        state0 = _mm_add_epi32(state0, save0);
+        state1 = _mm_add_epi32(state1, save1);
+    }
+
+    __m128i feba = _mm_shuffle_epi32(state0, 0x1b);
+    __m128i dchg = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+const size_t kLanes = 8;
+
+__attribute__((target("avx2"))) inline __m256i rotateLeft8(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+// po jedan blok za osam nezavisnih SHA-1 poruka; stanja su u SoA rasporedu state[rec][traka]
+__attribute__((target("avx2"))) void sha1Avx2Block(uint32_t (*state)[kLanes],
+                                                   const unsigned char* const* blocks) {
+    alignas(32) uint32_t lanes[kLanes];
+    __m256i w[16];
+    for (int t = 0; t < 16; ++t) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            lanes[lane] = loadBigEndian(blocks[lane] + 4 * t);
+        }
+        w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    }
+
+    __m256i h[5];
+    for (int i = 0; i < 5; ++i) {
+        h[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[i]));
+    }
+    __m256i a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+
+    for (int t = 0; t < 80; ++t) {
+        __m256i word = w[t & 15];
+        if (t >= 16) {
+            word = _mm256_xor_si256(_mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]),
+                                    _mm256_xor_si256(w[(t - 14) & 15], w[t & 15]));
+            word = rotateLeft8(word, 1);
+            w[t & 15] = word;
+        }
+
+        __m256i f;
+        uint32_t k;
+        if (t < 20) {
+            f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+            k = 0x5a827999;
+        } else if (t < 40) {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = 0x6ed9eba1;
+        } else if (t < 60) {
+            f = _mm256_or_si256(_mm256_and_si256(b, c),
+                                _mm256_and_si256(d, _mm256_or_si256(b, c)));
+            k = 0x8f1bbcdc;
+        } else {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = 0xca62c1d6;
+        }
+
+        __m256i temp = _mm256_add_epi32(_mm256_add_epi32(rotateLeft8(a, 5), f),
+                                        _mm256_add_epi32(_mm256_add_epi32(e, word),
+                                                         _mm256_set1_epi32(static_cast<int>(k))));
+        e = d;
+        d = c;
+        c = rotateLeft8(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    __m256i result[5] = {a, b, c, d, e};
+    for (int i = 0; i < 5; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[i]),
+                            _mm256_add_epi32(h[i], result[i]));
+    }
+}
+#endif
+
+bool cpuHasShaExtensions() {
+#ifdef GIT_HASHER_X86
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    bool sse = (ecx & bit_SSE4_1) && (ecx & bit_SSSE3);
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return sse && (ebx & (1u << 29));
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAvx2() {
+#ifdef GIT_HASHER_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+std::string objectHeader(git_object_t type, size_t size) {
+    std::string header = std::string(git_object_type2string(type)) + " " + std::to_string(size);
+    header.push_back('\0');
+    return header;
+}
+
+#ifdef GIT_HASHER_X86
+// poruka jedne trake: zaglavlje + sadrzaj + padding, citana blok po blok
+class LaneMessage {
+public:
+    LaneMessage(const git::ObjectHasher::Input& input)
+        : _header(objectHeader(input.type, input.size)),
+          _data(static_cast<const unsigned char*>(input.data)),
+          _size(input.size) {
+        _total  = _header.size() + _size;
+        _blocks = (_total + 8) / kBlockSize + 1;
+    }
+
+    size_t getBlockCount() const {
+        return _blocks;
+    }
+
+    const unsigned char* getBlock(size_t index, unsigned char* scratch) const {
+        size_t start = index * kBlockSize;
+        size_t body  = _header.size();
+        if (start >= body && start + kBlockSize <= body + _size) {
+            return _data + (start - body);
+        }
+
+        std::memset(scratch, 0, kBlockSize);
+        for (size_t i = 0; i < kBlockSize; ++i) {
+            size_t position = start + i;
+            if (position < body) {
+                scratch[i] = static_cast<unsigned char>(_header[position]);
+            } else if (position < _total) {
+                scratch[i] = _data[position - body];
+            } else if (position == _total) {
+                scratch[i] = 0x80;
+            }
+        }
+        if (index + 1 == _blocks) {
+            uint64_t bits = static_cast<uint64_t>(_total) * 8;
+            for (int i = 0; i < 8; ++i) {
+                scratch[56 + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+            }
+        }
+        return scratch;
+    }
+
+private:
+    std::string _header;
+    const unsigned char* _data;
+    size_t _size;
+    size_t _total;
+    size_t _blocks;
+};
+
+void hashObjectsAvx2(const std::vector<git::ObjectHasher::Input>& inputs,
+                     unsigned char* digests) {
+    struct Lane {
+        std::unique_ptr<LaneMessage> message;
+        size_t input = 0;
+        size_t block = 0;
+    };
+
+    Lane lanes[kLanes];
+    uint32_t state[5][kLanes];
+    alignas(16) unsigned char scratch[kLanes][kBlockSize];
+    const unsigned char idle[kBlockSize] = {};
+    size_t next                          = 0;
+
+    auto assign = [&](size_t lane) {
+        lanes[lane].message.reset();
+        if (next < inputs.size()) {
+            lanes[lane].message.reset(new LaneMessage(inputs[next]));
+            lanes[lane].input = next++;
+            lanes[lane].block = 0;
+            for (int i = 0; i < 5; ++i) {
+                state[i][lane] = kSha1Initial[i];
+            }
+        }
+    };
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        assign(lane);
+    }
+
+    // kada traka zavrsi svoju poruku odmah dobija sledecu, pa su trake stalno pune
+    while (true) {
+        const unsigned char* blocks[kLanes];
+        bool active = false;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            if (lanes[lane].message) {
+                blocks[lane] = lanes[lane].message->getBlock(lanes[lane].block, scratch[lane]);
+                active       = true;
+            } else {
+                blocks[lane] = idle;
+            }
+        }
+        if (!active) {
+            break;
+        }
+
+        sha1Avx2Block(state, blocks);
+
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            if (!lanes[lane].message ||
+                ++lanes[lane].block < lanes[lane].message->getBlockCount()) {
+                continue;
+            }
+            unsigned char* digest = digests + lanes[lane].input * GIT_OID_RAWSZ;
+            for (int i = 0; i < 5; ++i) {
+                digest[4 * i]     = static_cast<unsigned char>(state[i][lane] >> 24);
+                digest[4 * i + 1] = static_cast<unsigned char>(state[i][lane] >> 16);
+                digest[4 * i + 2] = static_cast<unsigned char>(state[i][lane] >> 8);
+                digest[4 * i + 3] = static_cast<unsigned char>(state[i][lane]);
+            }
+            assign(lane);
+        }
+    }
+}
+#endif
+
+}
+
+git::ObjectHasher::ObjectHasher(HashAlgorithm algorithm, Implementation implementation)
+    : _algorithm(algorithm), _implementation(implementation) {}
+
+git::ObjectHasher::Stream::Stream(BlockFunction blocks, const uint32_t* initial, size_t words)
+    : _blocks(blocks), _words(words) {
+    std::memcpy(_state, initial, words * sizeof(uint32_t));
+}
+
+void git::ObjectHasher::Stream::update(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    _length += size;
+
+    if (_buffered) {
+        size_t take = std::min(size, kBlockSize - _buffered);
+        std::memcpy(_buffer + _buffered, bytes, take);
+        _buffered += take;
+        bytes += take;
+        size -= take;
+        if (_buffered < kBlockSize) {
+            return;
+        }
+        _blocks(_state, _buffer, 1);
+        _buffered = 0;
+    }
+
+    if (size >= kBlockSize) {
+        _blocks(_state, bytes, size / kBlockSize);
+        bytes += size - size % kBlockSize;
+        size %= kBlockSize;
+    }
+
+    std::memcpy(_buffer, bytes, size);
+    _buffered = size;
+}
+
+void git::ObjectHasher::Stream::finish(unsigned char* digest) {
+    uint64_t bits = _length * 8;
+
+    unsigned char padding[2 * kBlockSize] = {0x80};
+    size_t padLength = (_buffered < 56 ? 56 : 120) - _buffered;
+    for (int i = 0; i < 8; ++i) {
+        padding[padLength + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    }
+    update(padding, padLength + 8);
+
+    for (size_t i = 0; i < _words; ++i) {
+        digest[4 * i]     = static_cast<unsigned char>(_state[i] >> 24);
+        digest[4 * i + 1] = static_cast<unsigned char>(_state[i] >> 16);
+        digest[4 * i + 2] = static_cast<unsigned char>(_state[i] >> 8);
+        digest[4 * i + 3] = static_cast<unsigned char>(_state[i]);
+    }
+}
+
+std::unique_ptr<git::ObjectHasher> git::ObjectHasher::create(HashAlgorithm algorithm,
+                                                             Implementation implementation) {
+    if (implementation == Implementation::Auto) {
+        implementation =
+            hasShaExtensions() ? Implementation::ShaExtensions : Implementation::Portable;
+    }
+    if (implementation == Implementation::ShaExtensions && !hasShaExtensions()) {
+        throw std::invalid_argument("SHA extensions are not available on this CPU.");
+    }
+    if (implementation == Implementation::CollisionDetecting && algorithm != HashAlgorithm::Sha1) {
+        throw std::invalid_argument("Collision detection is only defined for SHA-1.");
+    }
+
+    return std::unique_ptr<ObjectHasher>(new ObjectHasher(algorithm, implementation));
+}
+
+std::unique_ptr<git::ObjectHasher> git::ObjectHasher::forRepository(Repository* repo,
+                                                                    bool collisionDetection) {
+    HashAlgorithm algorithm = detectAlgorithm(repo);
+    if (collisionDetection && algorithm == HashAlgorithm::Sha1) {
+        return create(algorithm, Implementation::CollisionDetecting);
+    }
+    return create(algorithm);
+}
+
+git::HashAlgorithm git::ObjectHasher::detectAlgorithm(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    git_config* config = nullptr;
+    if (git_repository_config_snapshot(&config, repo->_repo) != 0) {
+        throw std::runtime_error("Failed to read repository config: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    git_buf format = GIT_BUF_INIT;
+    bool sha256    = git_config_get_string_buf(&format, config, "extensions.objectformat") == 0 &&
+                  std::string(format.ptr, format.size) == "sha256";
+    git_buf_dispose(&format);
+    git_config_free(config);
+
+    return sha256 ? HashAlgorithm::Sha256 : HashAlgorithm::Sha1;
+}
+
+bool git::ObjectHasher::hasShaExtensions() {
+    static const bool available = cpuHasShaExtensions();
+    return available;
+}
+
+bool git::ObjectHasher::hasAvx2() {
+    static const bool available = cpuHasAvx2();
+    return available;
+}
+
+git::HashAlgorithm git::ObjectHasher::getAlgorithm() const {
+    return _algorithm;
+}
+
+git::ObjectHasher::Implementation git::ObjectHasher::getImplementation() const {
+    return _implementation;
+}
+
+const char* git::ObjectHasher::getName() const {
+    if (_implementation == Implementation::CollisionDetecting) {
+        return "sha1dc";
+    }
+    bool accelerated = _implementation == Implementation::ShaExtensions;
+    if (_algorithm == HashAlgorithm::Sha1) {
+        return accelerated ? "sha1-shani" : "sha1-portable";
+    }
+    return accelerated ? "sha256-shani" : "sha256-portable";
+}
+
+size_t git::ObjectHasher::getDigestSize() const {
+    return _algorithm == HashAlgorithm::Sha1 ? 20 : 32;
+}
+
+git::ObjectHasher::Stream git::ObjectHasher::createStream() const {
+    if (_implementation == Implementation::CollisionDetecting) {
+        throw std::logic_error("Collision-detecting SHA-1 can only hash whole objects.");
+    }
+
+    BlockFunction blocks = _algorithm == HashAlgorithm::Sha1 ? sha1Portable : sha256Portable;
+#ifdef GIT_HASHER_X86
+    if (_implementation == Implementation::ShaExtensions) {
+        blocks = _algorithm == HashAlgorithm::Sha1 ? sha1ShaNi : sha256ShaNi;
+    }
+#endif
+
+    return Stream(blocks, _algorithm == HashAlgorithm::Sha1 ? kSha1Initial : kSha256Initial,
+                  getDigestSize() / 4);
+}
+
+void git::ObjectHasher::hash(const void* data, size_t size, unsigned char* digest) const {
+    Stream stream = createStream();
+    stream.update(data, size);
+    stream.finish(digest);
+}
+
+void git::ObjectHasher::hashObject(git_object_t type, const void* data, size_t size,
+                                   unsigned char* digest) const {
+    if (_implementation == Implementation::CollisionDetecting) {
+        git_oid oid;
+        if (git_odb_hash(&oid, data, size, type) != 0) {
+            throw std::runtime_error("Failed to hash object: " +
+                                     std::string(git_error_last()->message));
+        }
+        std::memcpy(digest, oid.id, GIT_OID_RAWSZ);
+        return;
+    }
+
+    std::string header = objectHeader(type, size);
+    Stream stream      = createStream();
+    stream.update(header.data(), header.size());
+    stream.update(data, size);
+    stream.finish(digest);
+}
+
+void git::ObjectHasher::hashObjects(const std::vector<Input>& inputs,
+                                    unsigned char* digests) const {
+#ifdef GIT_HASHER_X86
+    // bez SHA-NI, osam SHA-1 poruka paralelno u AVX2 registrima je brze od jedne po jedne
+    if (_algorithm == HashAlgorithm::Sha1 && _implementation == Implementation::Portable &&
+        inputs.size() > 1 && hasAvx2()) {
+        hashObjectsAvx2(inputs, digests);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        hashObject(inputs[i].type, inputs[i].data, inputs[i].size,
+                   digests + i * getDigestSize());
+    }
+}
+
+bool git::ObjectHasher::verifyObject(const unsigned char* expected, git_object_t type,
+                                     const void* data, size_t size) const {
+    unsigned char digest[kMaxDigestSize];
+    hashObject(type, data, size, digest);
+    return std::memcmp(digest, expected, getDigestSize()) == 0;
+}
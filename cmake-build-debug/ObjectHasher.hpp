@@ -0,0 +1,82 @@
+#ifndef PROBA_OBJECTHASHER_HPP
+#define PROBA_OBJECTHASHER_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+enum class HashAlgorithm { Sha1, Sha256 };
+
+// hesiranje objekata: SHA-NI kada ga procesor ima, AVX2 za vise SHA-1 poruka odjednom,
+// a libgit2 (sha1dc) kada je potrebna detekcija kolizija
+class ObjectHasher {
+public:
+    enum class Implementation { Auto, Portable, ShaExtensions, CollisionDetecting };
+
+    struct Input {
+        git_object_t type;
+        const void* data;
+        size_t size;
+    };
+
+    typedef void (*BlockFunction)(uint32_t* state, const unsigned char* data, size_t blocks);
+
+    // inkrementalno hesiranje sirovih bajtova, npr. za trailer packfile-a
+    class Stream {
+    public:
+        void update(const void* data, size_t size);
+        void finish(unsigned char* digest);
+
+    private:
+        friend class ObjectHasher;
+        Stream(BlockFunction blocks, const uint32_t* initial, size_t words);
+
+        BlockFunction _blocks;
+        size_t _words;
+        uint32_t _state[8]        = {};
+        unsigned char _buffer[64] = {};
+        size_t _buffered          = 0;
+        uint64_t _length          = 0;
+    };
+
+    static constexpr size_t kMaxDigestSize = 32;
+
+    static std::unique_ptr<ObjectHasher> create(
+        HashAlgorithm algorithm, Implementation implementation = Implementation::Auto);
+    static std::unique_ptr<ObjectHasher> forRepository(Repository* repo,
+                                                       bool collisionDetection = false);
+    static HashAlgorithm detectAlgorithm(Repository* repo);
+
+    static bool hasShaExtensions();
+    static bool hasAvx2();
+
+    HashAlgorithm getAlgorithm() const;
+    Implementation getImplementation() const;
+    const char* getName() const;
+    size_t getDigestSize() const;
+
+    Stream createStream() const;
+    void hash(const void* data, size_t size, unsigned char* digest) const;
+    void hashObject(git_object_t type, const void* data, size_t size, unsigned char* digest) const;
+    void hashObjects(const std::vector<Input>& inputs, unsigned char* digests) const;
+    bool verifyObject(const unsigned char* expected, git_object_t type, const void* data,
+                      size_t size) const;
+
+private:
+    ObjectHasher(HashAlgorithm algorithm, Implementation implementation);
+
+    HashAlgorithm _algorithm;
+    Implementation _implementation;
+};
+
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include "OidSet.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+uint64_t loadPrefix(const unsigned char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return __builtin_bswap64(value);
+}
+
+// prvih 8 bajtova kao jedan big-endian broj resava skoro svako poredjenje
+int compareOids(const unsigned char* a, const unsigned char* b, size_t size) {
+    uint64_t x = loadPrefix(a);
+    uint64_t y = loadPrefix(b);
+    if (x != y) {
+        return x < y ? -1 : 1;
+    }
+    return std::memcmp(a + 8, b + 8, size - 8);
+}
+
+bool equalOids(const unsigned char* a, const unsigned char* b, size_t size) {
+#ifdef __SSE2__
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) {
+        return false;
+    }
+    return std::memcmp(a + 16, b + 16, size - 16) == 0;
+#else
+    return std::memcmp(a, b, size) == 0;
+#endif
+}
+
+}
+
+git::OidSet::OidSet(size_t oidSize) : _oidSize(oidSize) {
+    if (oidSize != 20 && oidSize != 32) {
+        throw std::invalid_argument("Unsupported OID size: " + std::to_string(oidSize));
+    }
+}
+
+void git::OidSet::reserve(size_t count) {
+    _data.reserve(count * _oidSize);
+}
+
+void git::OidSet::insert(const git_oid* oid) {
+    if (_oidSize > sizeof(oid->id)) {
+        throw std::invalid_argument("git_oid is smaller than the OID size of the set.");
+    }
+    insert(oid->id);
+}
+
+void git::OidSet::insert(const unsigned char* rawOid) {
+    // OID-ovi koji stizu vec sortirani (npr. iz .idx fajla) ne zahtevaju ponovno sortiranje
+    if (_sorted && !_data.empty()) {
+        int order = compareOids(&_data[_data.size() - _oidSize], rawOid, _oidSize);
+        if (order == 0) {
+            return;
+        }
+        _sorted = order < 0;
+    }
+    _data.insert(_data.end(), rawOid, rawOid + _oidSize);
+    _dirty = true;
+}
+
+void git::OidSet::normalize() const {
+    if (!_dirty) {
+        return;
+    }
+    if (_sorted) {
+        buildFanout();
+        _dirty = false;
+        return;
+    }
+
+    size_t count = _data.size() / _oidSize;
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return compareOids(&_data[a * _oidSize], &_data[b * _oidSize], _oidSize) < 0;
+    });
+
+    std::vector<unsigned char> sorted;
+    sorted.reserve(_data.size());
+    for (uint32_t index : order) {
+        const unsigned char* oid = &_data[index * _oidSize];
+        if (!sorted.empty() && equalOids(&sorted[sorted.size() - _oidSize], oid, _oidSize)) {
+            continue;
+        }
+        sorted.insert(sorted.end(), oid, oid + _oidSize);
+    }
+
+    _data.swap(sorted);
+    _sorted = true;
+    _dirty  = false;
+    buildFanout();
+}
+
+void git::OidSet::buildFanout() const {
+    size_t count = _data.size() / _oidSize;
+    size_t index = 0;
+    for (int byte = 0; byte < 256; ++byte) {
+        while (index < count && _data[index * _oidSize] < byte) {
+            ++index;
+        }
+        _fanout[byte] = static_cast<uint32_t>(index);
+    }
+    _fanout[256] = static_cast<uint32_t>(count);
+}
+
+bool git::OidSet::contains(const git_oid* oid) const {
+    return contains(oid->id);
+}
+
+bool git::OidSet::contains(const unsigned char* rawOid) const {
+    size_t index;
+    return find(rawOid, &index);
+}
+
+bool git::OidSet::find(const unsigned char* rawOid, size_t* index) const {
+    normalize();
+
+    size_t lo = _fanout[rawOid[0]];
+    size_t hi = _fanout[rawOid[0] + 1];
+    while (hi - lo > kLinearScan) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compareOids(&_data[mid * _oidSize], rawOid, _oidSize) < 0) {
+            lo = mid + 1;
+        } else {
+            if (equalOids(&_data[mid * _oidSize], rawOid, _oidSize)) {
+                *index = mid;
+                return true;
+            }
+            hi = mid;
+        }
+    }
+
+    for (; lo < hi; ++lo) {
+        if (equalOids(&_data[lo * _oidSize], rawOid, _oidSize)) {
+            *index = lo;
+            return true;
+        }
+    }
+    return false;
+}
+
+// galopiranje od from: cena je log razmaka do trazenog OID-a, a ne log velicine skupa
+size_t git::OidSet::lowerBound(const unsigned char* rawOid, size_t from) const {
+    size_t lo  = std::max<size_t>(from, _fanout[rawOid[0]]);
+    size_t end = std::max<size_t>(from, _fanout[rawOid[0] + 1]);
+
+    size_t step = 1;
+    size_t hi   = lo;
+    while (hi < end && compareOids(&_data[hi * _oidSize], rawOid, _oidSize) < 0) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = std::min(hi, end);
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compareOids(&_data[mid * _oidSize], rawOid, _oidSize) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool git::OidSet::intersects(const OidSet& other) const {
+    if (_oidSize != other._oidSize) {
+        throw std::invalid_argument("OID sets use different OID sizes.");
+    }
+    normalize();
+    other.normalize();
+
+    size_t i = 0, j = 0;
+    while (i < size() && j < other.size()) {
+        int order = compareOids(at(i), other.at(j), _oidSize);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            i = lowerBound(other.at(j), i);
+        } else {
+            j = other.lowerBound(at(i), j);
+        }
+    }
+    return false;
+}
+
+git::OidSet git::OidSet::intersect(const OidSet& a, const OidSet& b) {
+    if (a._oidSize != b._oidSize) {
+        throw std::invalid_argument("OID sets use different OID sizes.");
+    }
+    a.normalize();
+    b.normalize();
+
+    OidSet result(a._oidSize);
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        int order = compareOids(a.at(i), b.at(j), a._oidSize);
+        if (order == 0) {
+            result._data.insert(result._data.end(), a.at(i), a.at(i) + a._oidSize);
+            ++i;
+            ++j;
+        } else if (order < 0) {
+            i = a.lowerBound(b.at(j), i);
+        } else {
+            j = b.lowerBound(a.at(i), j);
+        }
+    }
+
+    result.buildFanout();
+    return result;
+}
+
+git::OidSet git::OidSet::difference(const OidSet& a, const OidSet& b) {
+    if (a._oidSize != b._oidSize) {
+        throw std::invalid_argument("OID sets use different OID sizes.");
+    }
+    a.normalize();
+    b.normalize();
+
+    OidSet result(a._oidSize);
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        int order = compareOids(a.at(i), b.at(j), a._oidSize);
+        if (order == 0) {
+            ++i;
+            ++j;
+        } else if (order < 0) {
+            size_t next = a.lowerBound(b.at(j), i);
+            result._data.insert(result._data.end(), a.at(i), a.at(next - 1) + a._oidSize);
+            i = next;
+        } else {
+            j = b.lowerBound(a.at(i), j);
+        }
+    }
+    if (i < a.size()) {
+        result._data.insert(result._data.end(), a.at(i), a.at(0) + a._data.size());
+    }
+
+    result.buildFanout();
+    return result;
+}
+
+git::OidSet git::OidSet::unite(const OidSet& a, const OidSet& b) {
+    if (a._oidSize != b._oidSize) {
+        throw std::invalid_argument("OID sets use different OID sizes.");
+    }
+    a.normalize();
+    b.normalize();
+
+    OidSet result(a._oidSize);
+    result._data.reserve(a._data.size() + b._data.size());
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        int order = compareOids(a.at(i), b.at(j), a._oidSize);
+        if (order == 0) {
+            result._data.insert(result._data.end(), a.at(i), a.at(i) + a._oidSize);
+            ++i;
+            ++j;
+        } else if (order < 0) {
+            size_t next = a.lowerBound(b.at(j), i);
+            result._data.insert(result._data.end(), a.at(i), a.at(next - 1) + a._oidSize);
+            i = next;
+        } else {
+            size_t next = b.lowerBound(a.at(i), j);
+            result._data.insert(result._data.end(), b.at(j), b.at(next - 1) + b._oidSize);
+            j = next;
+        }
+    }
+    if (i < a.size()) {
+        result._data.insert(result._data.end(), a.at(i), a.at(0) + a._data.size());
+    }
+    if (j < b.size()) {
+        result._data.insert(result._data.end(), b.at(j), b.at(0) + b._data.size());
+    }
+
+    result.buildFanout();
+    return result;
+}
+
+size_t git::OidSet::size() const {
+    normalize();
+    return _data.size() / _oidSize;
+}
+
+bool git::OidSet::empty() const {
+    return _data.empty();
+}
+
+size_t git::OidSet::getOidSize() const {
+    return _oidSize;
+}
+
+const unsigned char* git::OidSet::at(size_t index) const {
+    normalize();
+    return &_data[index * _oidSize];
+}
+
+git_oid git::OidSet::getOid(size_t index) const {
+    git_oid oid = {};
+    std::memcpy(oid.id, at(index), std::min(_oidSize, sizeof(oid.id)));
+    return oid;
+}
@@ -0,0 +1,54 @@
+#ifndef PROBA_OIDSET_HPP
+#define PROBA_OIDSET_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace git {
+
+// skup OID-ova u jednom sortiranom nizu (20 ili 32 bajta po OID-u) sa fanout tabelom
+// po prvom bajtu; umesto std::set<std::string> u analizama grafa grana
+class OidSet {
+public:
+    static constexpr size_t kLinearScan = 8;
+
+    explicit OidSet(size_t oidSize = GIT_OID_RAWSZ);
+
+    void reserve(size_t count);
+    void insert(const git_oid* oid);
+    void insert(const unsigned char* rawOid);
+    // sortira i uklanja duplikate; upiti ga pozivaju sami, ali tada skup nije thread-safe
+    void normalize() const;
+
+    bool contains(const git_oid* oid) const;
+    bool contains(const unsigned char* rawOid) const;
+    bool find(const unsigned char* rawOid, size_t* index) const;
+    bool intersects(const OidSet& other) const;
+
+    static OidSet intersect(const OidSet& a, const OidSet& b);
+    static OidSet difference(const OidSet& a, const OidSet& b);
+    static OidSet unite(const OidSet& a, const OidSet& b);
+
+    size_t size() const;
+    bool empty() const;
+    size_t getOidSize() const;
+    const unsigned char* at(size_t index) const;
+    git_oid getOid(size_t index) const;
+
+private:
+    size_t lowerBound(const unsigned char* rawOid, size_t from) const;
+    void buildFanout() const;
+
+    size_t _oidSize;
+    mutable std::vector<unsigned char> _data;
+    mutable uint32_t _fanout[257] = {};
+    mutable bool _sorted          = true;
+    mutable bool _dirty           = false;
+};
+
+}
+
+#endif
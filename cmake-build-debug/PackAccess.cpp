@@ -0,0 +1,536 @@
+#include "PackAccess.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t kIndexMagic   = 0xff744f63;
+const uint32_t kPackMagic    = 0x5041434b;
+const size_t kPackHeaderSize = 12;
+
+uint32_t readBigEndian32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t readBigEndian64(const unsigned char* p) {
+    return (static_cast<uint64_t>(readBigEndian32(p)) << 32) | readBigEndian32(p + 4);
+}
+
+// deljene instance po pack direktorijumu i nacinu pristupa
+struct CachedAccess {
+    std::shared_ptr<const git::PackAccess> access;
+    int64_t signature = 0;
+    uint64_t lastUse  = 0;
+};
+
+const size_t kMaxCachedDirectories = 8;
+
+std::mutex cacheMutex;
+std::map<std::pair<std::string, int>, CachedAccess> accessCache;
+uint64_t cacheClock = 0;
+
+// dodavanje ili brisanje packa menja mtime direktorijuma; 0 ako direktorijum ne postoji
+int64_t directorySignature(const std::string& directory) {
+    struct stat st;
+    if (stat(directory.c_str(), &st) != 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+size_t pageSize() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// vraca nullptr ako fajl ne postoji (npr. repack ga je upravo obrisao)
+const unsigned char* mapFile(const std::string& path, size_t* size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return nullptr;
+        }
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat " + path);
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map " + path + ": " + std::strerror(errno));
+    }
+
+    *size = static_cast<size_t>(st.st_size);
+    return static_cast<const unsigned char*>(data);
+}
+
+int adviceFor(git::AccessPattern pattern) {
+    return pattern == git::AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM;
+}
+
+}
+
+git::PackFile::PackFile(const std::string& path) : _path(path) {}
+
+git::PackFile::~PackFile() {
+    if (_pack) {
+        munmap(const_cast<unsigned char*>(_pack), _packSize);
+    }
+    if (_index) {
+        munmap(const_cast<unsigned char*>(_index), _indexSize);
+    }
+}
+
+std::unique_ptr<git::PackFile> git::PackFile::open(const std::string& packPath,
+                                                   AccessPattern pattern, bool hugePages) {
+    const std::string suffix = ".pack";
+    if (packPath.size() <= suffix.size() ||
+        packPath.compare(packPath.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        throw std::invalid_argument("Not a packfile path: " + packPath);
+    }
+
+    std::unique_ptr<PackFile> pack(new PackFile(packPath));
+
+    pack->_pack = mapFile(packPath, &pack->_packSize);
+    if (!pack->_pack) {
+        return nullptr;
+    }
+    if (pack->_packSize < kPackHeaderSize || readBigEndian32(pack->_pack) != kPackMagic) {
+        throw std::runtime_error("Invalid packfile header: " + packPath);
+    }
+
+    pack->loadIndex(packPath.substr(0, packPath.size() - suffix.size()) + ".idx");
+    if (!pack->_index) {
+        return nullptr;
+    }
+    if (readBigEndian32(pack->_pack + 8) != pack->_objectCount) {
+        throw std::runtime_error("Packfile and index disagree on object count: " + packPath);
+    }
+
+    pack->advise(pattern);
+
+#ifdef MADV_HUGEPAGE
+    // za velike packove trazimo THP; kernel bez podrske za file THP ovo tiho ignorise
+    if (hugePages && pack->_packSize >= PackAccess::kHugePageThreshold) {
+        madvise(const_cast<unsigned char*>(pack->_pack), pack->_packSize, MADV_HUGEPAGE);
+    }
+#else
+    (void)hugePages;
+#endif
+
+    return pack;
+}
+
+void git::PackFile::loadIndex(const std::string& indexPath) {
+    _index = mapFile(indexPath, &_indexSize);
+    if (!_index) {
+        return;
+    }
+
+    const size_t headerSize = 8 + 256 * 4;
+    if (_indexSize < headerSize || readBigEndian32(_index) != kIndexMagic ||
+        readBigEndian32(_index + 4) != 2) {
+        throw std::runtime_error("Unsupported pack index version: " + indexPath);
+    }
+
+    for (size_t i = 0; i < 256; ++i) {
+        _fanout[i] = readBigEndian32(_index + 8 + i * 4);
+    }
+    _objectCount = _fanout[255];
+
+    // velicina OID-a nije zapisana u v2 indeksu, pa je izvodimo iz velicine fajla
+    bool found = false;
+    for (size_t oidSize : {static_cast<size_t>(20), static_cast<size_t>(32)}) {
+        size_t fixed = headerSize + _objectCount * (oidSize + 8) + 2 * oidSize;
+        if (_indexSize < fixed || (_indexSize - fixed) % 8 != 0) {
+            continue;
+        }
+        size_t large = (_indexSize - fixed) / 8;
+        if (large > _objectCount) {
+            continue;
+        }
+        _oidSize          = oidSize;
+        _largeOffsetCount = large;
+        found             = true;
+        break;
+    }
+    if (!found) {
+        throw std::runtime_error("Corrupt pack index: " + indexPath);
+    }
+
+    _oids      = _index + headerSize;
+    _offsets   = _oids + _objectCount * (_oidSize + 4);
+    _offsets64 = _offsets + _objectCount * 4;
+
+    // indeks je mali i pristupa mu se nasumicno, pa ga odmah ucitavamo
+    madvise(const_cast<unsigned char*>(_index), _indexSize, MADV_WILLNEED);
+}
+
+bool git::PackFile::findOffset(const git_oid* oid, uint64_t* offset) const {
+    return findOffset(oid->id, offset);
+}
+
+bool git::PackFile::findOffset(const unsigned char* rawOid, uint64_t* offset) const {
+    size_t low  = rawOid[0] == 0 ? 0 : _fanout[rawOid[0] - 1];
+    size_t high = _fanout[rawOid[0]];
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int cmp    = std::memcmp(rawOid, _oids + mid * _oidSize, _oidSize);
+        if (cmp == 0) {
+            if (offset) {
+                *offset = getOffsetAt(mid);
+            }
+            return true;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return false;
+}
+
+uint64_t git::PackFile::getOffsetAt(size_t index) const {
+    uint32_t offset = readBigEndian32(_offsets + index * 4);
+    if (!(offset & 0x80000000u)) {
+        return offset;
+    }
+
+    size_t large = offset & 0x7fffffffu;
+    if (large >= _largeOffsetCount) {
+        throw std::runtime_error("Corrupt large offset in pack index: " + _path);
+    }
+    return readBigEndian64(_offsets64 + large * 8);
+}
+
+void git::PackFile::buildReverseIndex() const {
+    std::call_once(_reverseIndexOnce, [this]() {
+        _offsetOrder.resize(_objectCount);
+        for (size_t i = 0; i < _objectCount; ++i) {
+            _offsetOrder[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(_offsetOrder.begin(), _offsetOrder.end(),
+                  [this](uint32_t a, uint32_t b) { return getOffsetAt(a) < getOffsetAt(b); });
+
+        _sortedOffsets.reserve(_objectCount + 1);
+        for (uint32_t index : _offsetOrder) {
+            _sortedOffsets.push_back(getOffsetAt(index));
+        }
+        // kraj poslednjeg objekta je pocetak trailer checksum-a
+        _sortedOffsets.push_back(_packSize - _oidSize);
+    });
+}
+
+uint64_t git::PackFile::getEntryLength(uint64_t offset) const {
+    buildReverseIndex();
+
+    auto it = std::upper_bound(_sortedOffsets.begin(), _sortedOffsets.end(), offset);
+    if (it == _sortedOffsets.begin() || it == _sortedOffsets.end() || *(it - 1) != offset) {
+        throw std::invalid_argument("Offset is not the start of a pack entry: " + _path);
+    }
+    return *it - offset;
+}
+
+uint64_t git::PackFile::estimateEntryLength(uint64_t offset, uint64_t next) const {
+    uint64_t end = std::min<uint64_t>(next, _packSize - _oidSize);
+
+    EntryHeader header;
+    if (readEntryHeader(offset, &header)) {
+        // compressBound iz zlib-a
+        uint64_t size  = header.size;
+        uint64_t bound = size + (size >> 12) + (size >> 14) + (size >> 25) + 13;
+        end            = std::min(end, header.dataOffset + bound);
+    }
+    return end > offset ? end - offset : 0;
+}
+
+const unsigned char* git::PackFile::getOidAtOffset(uint64_t offset) const {
+    buildReverseIndex();
+
+    auto it = std::lower_bound(_sortedOffsets.begin(), _sortedOffsets.end() - 1, offset);
+    if (it == _sortedOffsets.end() - 1 || *it != offset) {
+        return nullptr;
+    }
+    return getOidAt(_offsetOrder[it - _sortedOffsets.begin()]);
+}
+
+bool git::PackFile::readEntryHeader(uint64_t offset, EntryHeader* header) const {
+    if (offset < kPackHeaderSize || offset >= _packSize - _oidSize) {
+        return false;
+    }
+
+    uint64_t pos    = offset;
+    unsigned char c = _pack[pos++];
+    header->type    = (c >> 4) & 7;
+    header->size    = c & 0x0f;
+    for (int shift = 4; (c & 0x80) && pos < _packSize; shift += 7) {
+        c = _pack[pos++];
+        header->size |= static_cast<uint64_t>(c & 0x7f) << shift;
+    }
+
+    header->baseOffset = 0;
+    header->baseOid    = nullptr;
+    if (header->type == GIT_OBJECT_OFS_DELTA) {
+        if (!getDeltaBase(offset, &header->baseOffset)) {
+            return false;
+        }
+        do {
+            c = _pack[pos++];
+        } while ((c & 0x80) && pos < _packSize);
+    } else if (header->type == GIT_OBJECT_REF_DELTA) {
+        if (pos + _oidSize > _packSize) {
+            return false;
+        }
+        header->baseOid = _pack + pos;
+        pos += _oidSize;
+    }
+
+    header->dataOffset = pos;
+    return pos < _packSize;
+}
+
+size_t git::PackFile::getObjectCount() const {
+    return _objectCount;
+}
+
+size_t git::PackFile::getOidSize() const {
+    return _oidSize;
+}
+
+const unsigned char* git::PackFile::getOidAt(size_t index) const {
+    return _oids + index * _oidSize;
+}
+
+const uint32_t* git::PackFile::getFanout() const {
+    return _fanout;
+}
+
+const unsigned char* git::PackFile::getData() const {
+    return _pack;
+}
+
+size_t git::PackFile::getSize() const {
+    return _packSize;
+}
+
+const std::string& git::PackFile::getPath() const {
+    return _path;
+}
+
+void git::PackFile::advise(AccessPattern pattern) const {
+    madvise(const_cast<unsigned char*>(_pack), _packSize, adviceFor(pattern));
+}
+
+void git::PackFile::readahead(uint64_t offset, uint64_t length) const {
+    if (offset >= _packSize) {
+        return;
+    }
+    length = std::min<uint64_t>(length, _packSize - offset);
+
+    uint64_t start = offset & ~static_cast<uint64_t>(pageSize() - 1);
+    madvise(const_cast<unsigned char*>(_pack) + start, offset + length - start, MADV_WILLNEED);
+}
+
+bool git::PackFile::getDeltaBase(uint64_t offset, uint64_t* baseOffset) const {
+    if (offset < kPackHeaderSize || offset >= _packSize - _oidSize) {
+        return false;
+    }
+
+    uint64_t pos    = offset;
+    unsigned char c = _pack[pos++];
+    int type        = (c >> 4) & 7;
+    while ((c & 0x80) && pos < _packSize) {
+        c = _pack[pos++];
+    }
+
+    if (type == GIT_OBJECT_OFS_DELTA) {
+        if (pos >= _packSize) {
+            return false;
+        }
+        c                 = _pack[pos++];
+        uint64_t relative = c & 0x7f;
+        while ((c & 0x80) && pos < _packSize) {
+            c        = _pack[pos++];
+            relative = ((relative + 1) << 7) | (c & 0x7f);
+        }
+        if (relative == 0 || relative > offset) {
+            return false;
+        }
+        *baseOffset = offset - relative;
+        return true;
+    }
+
+    if (type == GIT_OBJECT_REF_DELTA) {
+        // baza thin delta objekta moze biti u drugom packu, tada staje lanac
+        return pos + _oidSize <= _packSize && findOffset(_pack + pos, baseOffset);
+    }
+
+    return false;
+}
+
+uint64_t git::PackFile::getChainBase(uint64_t offset, size_t maxDepth) const {
+    uint64_t base = offset;
+    for (size_t depth = 0; depth < maxDepth && getDeltaBase(offset, &base); ++depth) {
+        offset = base;
+    }
+    return offset;
+}
+
+size_t git::PackFile::readaheadDeltaChain(uint64_t offset, size_t maxDepth) const {
+    size_t depth = 0;
+
+    while (depth < maxDepth) {
+        readahead(offset, getEntryLength(offset));
+        ++depth;
+
+        if (!getDeltaBase(offset, &offset)) {
+            break;
+        }
+    }
+
+    return depth;
+}
+
+git::PackAccess::PackAccess(const std::string& directory, AccessPattern pattern, bool hugePages)
+    : _directory(directory), _pattern(pattern), _hugePages(hugePages) {}
+
+std::unique_ptr<git::PackAccess> git::PackAccess::create(Repository* repo, AccessPattern pattern,
+                                                         bool hugePages) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::unique_ptr<PackAccess> access(new PackAccess(packDirectoryOf(repo), pattern, hugePages));
+    access->refresh();
+    return access;
+}
+
+std::shared_ptr<const git::PackAccess> git::PackAccess::forRepository(Repository* repo,
+                                                                      AccessPattern pattern) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::string directory = packDirectoryOf(repo);
+    int64_t signature     = directorySignature(directory);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    CachedAccess& cached = accessCache[std::make_pair(directory, static_cast<int>(pattern))];
+    if (!cached.access || cached.signature != signature) {
+        std::unique_ptr<PackAccess> access(new PackAccess(directory, pattern, false));
+        access->refresh();
+        cached.access    = std::move(access);
+        cached.signature = signature;
+    }
+    cached.lastUse = ++cacheClock;
+    auto access    = cached.access;
+
+    // najduze nekorisceni direktorijum se pusta; mape ostaju dok ih neko jos drzi
+    if (accessCache.size() > kMaxCachedDirectories) {
+        auto oldest = accessCache.begin();
+        for (auto it = accessCache.begin(); it != accessCache.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+        accessCache.erase(oldest);
+    }
+    return access;
+}
+
+void git::PackAccess::refresh() {
+    std::string directory = getPackDirectory();
+
+    std::vector<std::unique_ptr<PackFile>> packs;
+    DIR* dir = opendir(directory.c_str());
+    if (dir) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() <= 5 || name.compare(name.size() - 5, 5, ".pack") != 0) {
+                continue;
+            }
+            auto pack = PackFile::open(directory + "/" + name, _pattern, _hugePages);
+            if (pack) {
+                packs.push_back(std::move(pack));
+            }
+        }
+        closedir(dir);
+    }
+
+    // vece packove pretrazujemo prve jer sadrze vecinu objekata
+    std::sort(packs.begin(), packs.end(),
+              [](const std::unique_ptr<PackFile>& a, const std::unique_ptr<PackFile>& b) {
+                  return a->getObjectCount() > b->getObjectCount();
+              });
+
+    _packs = std::move(packs);
+}
+
+void git::PackAccess::setPattern(AccessPattern pattern) {
+    if (_pattern == pattern) {
+        return;
+    }
+
+    _pattern = pattern;
+    for (const auto& pack : _packs) {
+        pack->advise(pattern);
+    }
+}
+
+git::AccessPattern git::PackAccess::getPattern() const {
+    return _pattern;
+}
+
+bool git::PackAccess::locate(const git_oid* oid, const PackFile** pack, uint64_t* offset) const {
+    for (const auto& candidate : _packs) {
+        if (candidate->findOffset(oid, offset)) {
+            if (pack) {
+                *pack = candidate.get();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t git::PackAccess::readahead(const git_oid* oid, size_t maxDepth) const {
+    const PackFile* pack = nullptr;
+    uint64_t offset      = 0;
+    if (!locate(oid, &pack, &offset)) {
+        return 0;
+    }
+    return pack->readaheadDeltaChain(offset, maxDepth);
+}
+
+const std::vector<std::unique_ptr<git::PackFile>>& git::PackAccess::getPacks() const {
+    return _packs;
+}
+
+std::string git::PackAccess::getPackDirectory() const {
+    return _directory;
+}
+
+std::string git::PackAccess::packDirectoryOf(Repository* repo) {
+    return std::string(git_repository_commondir(repo->_repo)) + "objects/pack";
+}
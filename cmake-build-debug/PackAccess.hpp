@@ -0,0 +1,131 @@
+#ifndef PROBA_PACKACCESS_HPP
+#define PROBA_PACKACCESS_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+enum class AccessPattern { Sequential, Random };
+
+// jedan packfile zajedno sa svojim .idx fajlom, oba mapirana samo za citanje
+class PackFile {
+public:
+    struct EntryHeader {
+        int type                     = 0;
+        uint64_t size                = 0;
+        uint64_t dataOffset          = 0;
+        uint64_t baseOffset          = 0;
+        const unsigned char* baseOid = nullptr;
+    };
+
+    PackFile(const PackFile&)            = delete;
+    PackFile& operator=(const PackFile&) = delete;
+    ~PackFile();
+
+    static std::unique_ptr<PackFile> open(const std::string& packPath, AccessPattern pattern,
+                                          bool hugePages);
+
+    bool findOffset(const git_oid* oid, uint64_t* offset) const;
+    bool findOffset(const unsigned char* rawOid, uint64_t* offset) const;
+    uint64_t getEntryLength(uint64_t offset) const;
+    // gornja granica duzine zapisa bez reverse indeksa: do next (sledeci poznat pocetak
+    // zapisa), ali ne preko zaglavlja i zlib granice za deklarisanu velicinu
+    uint64_t estimateEntryLength(uint64_t offset, uint64_t next) const;
+    bool readEntryHeader(uint64_t offset, EntryHeader* header) const;
+    const unsigned char* getOidAtOffset(uint64_t offset) const;
+    bool getDeltaBase(uint64_t offset, uint64_t* baseOffset) const;
+    uint64_t getChainBase(uint64_t offset, size_t maxDepth) const;
+
+    size_t getObjectCount() const;
+    size_t getOidSize() const;
+    const unsigned char* getOidAt(size_t index) const;
+    uint64_t getOffsetAt(size_t index) const;
+    const uint32_t* getFanout() const;
+
+    const unsigned char* getData() const;
+    size_t getSize() const;
+    const std::string& getPath() const;
+
+    void advise(AccessPattern pattern) const;
+    void readahead(uint64_t offset, uint64_t length) const;
+    size_t readaheadDeltaChain(uint64_t offset, size_t maxDepth) const;
+
+private:
+    explicit PackFile(const std::string& path);
+
+    void loadIndex(const std::string& indexPath);
+    void buildReverseIndex() const;
+
+    std::string _path;
+
+    const unsigned char* _pack  = nullptr;
+    size_t _packSize            = 0;
+    const unsigned char* _index = nullptr;
+    size_t _indexSize           = 0;
+
+    uint32_t _fanout[256] = {};
+    size_t _objectCount   = 0;
+    size_t _oidSize       = GIT_OID_RAWSZ;
+
+    const unsigned char* _oids      = nullptr;
+    const unsigned char* _offsets   = nullptr;
+    const unsigned char* _offsets64 = nullptr;
+    size_t _largeOffsetCount        = 0;
+
+    mutable std::once_flag _reverseIndexOnce;
+    mutable std::vector<uint64_t> _sortedOffsets;
+    mutable std::vector<uint32_t> _offsetOrder;
+};
+
+// sloj ispod Repository koji cita packove preko mmap-a sa naznakama o nacinu pristupa
+class PackAccess {
+public:
+    static constexpr uint64_t kHugePageThreshold = 256ull * 1024 * 1024;
+    static constexpr size_t kMaxDeltaDepth       = 50;
+
+    PackAccess(const PackAccess&)            = delete;
+    PackAccess& operator=(const PackAccess&) = delete;
+
+    static std::unique_ptr<PackAccess> create(Repository* repo,
+                                              AccessPattern pattern = AccessPattern::Random,
+                                              bool hugePages        = false);
+    // deljena instanca za pack direktorijum repozitorijuma; pamti se po putanji, ne po
+    // Repository pokazivacu, i pravi se iznova tek kada se direktorijum promeni (nov ili
+    // obrisan pack), pa uzastopni checkout-i i merge-ovi ne mapiraju packove ponovo
+    static std::shared_ptr<const PackAccess> forRepository(
+        Repository* repo, AccessPattern pattern = AccessPattern::Random);
+
+    void refresh();
+
+    void setPattern(AccessPattern pattern);
+    AccessPattern getPattern() const;
+
+    bool locate(const git_oid* oid, const PackFile** pack, uint64_t* offset) const;
+    size_t readahead(const git_oid* oid, size_t maxDepth = kMaxDeltaDepth) const;
+
+    const std::vector<std::unique_ptr<PackFile>>& getPacks() const;
+    std::string getPackDirectory() const;
+
+private:
+    PackAccess(const std::string& directory, AccessPattern pattern, bool hugePages);
+
+    static std::string packDirectoryOf(Repository* repo);
+
+    std::string _directory;
+    AccessPattern _pattern;
+    bool _hugePages;
+    std::vector<std::unique_ptr<PackFile>> _packs;
+};
+
+}
+
+#endif
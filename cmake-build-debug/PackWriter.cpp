@@ -0,0 +1,698 @@
+#include "PackWriter.hpp"
+
+#include "Branch.hpp"
+#include "CompressionBackend.hpp"
+#include "ObjectHasher.hpp"
+#include "PackAccess.hpp"
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+const size_t kBlock         = 16;
+const size_t kMaxInsert     = 127;
+const size_t kMaxCopy       = 0xffffff;
+const size_t kMinDeltaInput = 64;
+
+// isti hes putanje kao git: poslednji znakovi imena najvise uticu na redosled
+uint32_t nameHash(const std::string& path) {
+    uint32_t hash = 0;
+    for (unsigned char c : path) {
+        if (std::isspace(c)) {
+            continue;
+        }
+        hash = (hash >> 2) + (static_cast<uint32_t>(c) << 24);
+    }
+    return hash;
+}
+
+size_t encodeEntryHeader(int type, uint64_t size, unsigned char* out) {
+    size_t length = 0;
+    unsigned char c = static_cast<unsigned char>((type << 4) | (size & 0x0f));
+    size >>= 4;
+    while (size) {
+        out[length++] = c | 0x80;
+        c             = size & 0x7f;
+        size >>= 7;
+    }
+    out[length++] = c;
+    return length;
+}
+
+// OFS_DELTA rastojanje u git-ovom formatu, zapisano od kraja bafera
+size_t encodeDeltaOffset(uint64_t distance, unsigned char* out) {
+    unsigned char buffer[16];
+    size_t pos    = sizeof(buffer) - 1;
+    buffer[pos]   = distance & 0x7f;
+    while (distance >>= 7) {
+        buffer[--pos] = 0x80 | (--distance & 0x7f);
+    }
+    size_t length = sizeof(buffer) - pos;
+    std::memcpy(out, buffer + pos, length);
+    return length;
+}
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(0x80 | (value & 0x7f)));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint32_t hashBlock(const unsigned char* p) {
+    uint64_t a, b;
+    std::memcpy(&a, p, sizeof(a));
+    std::memcpy(&b, p + 8, sizeof(b));
+    uint64_t h = a * 0x9e3779b97f4a7c15ull ^ b * 0xc2b2ae3d27d4eb4full;
+    return static_cast<uint32_t>(h >> 32);
+}
+
+// indeks baze po blokovima od 16 bajtova; delta je niz copy/insert instrukcija
+class DeltaIndex {
+public:
+    explicit DeltaIndex(std::string base) : _base(std::move(base)) {
+        size_t blocks = _base.size() / kBlock;
+        size_t size   = 16;
+        while (size < blocks * 2) {
+            size <<= 1;
+        }
+        _mask = static_cast<uint32_t>(size - 1);
+        _table.assign(size, 0);
+
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(_base.data());
+        for (size_t i = 0; i + kBlock <= _base.size(); i += kBlock) {
+            _table[hashBlock(data + i) & _mask] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    size_t size() const {
+        return _base.size();
+    }
+
+    bool encode(const std::string& target, size_t limit, std::string& out) const {
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(_base.data());
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(target.data());
+        size_t baseSize           = _base.size();
+        size_t size               = target.size();
+
+        out.clear();
+        appendVarint(out, baseSize);
+        appendVarint(out, size);
+
+        size_t pos     = 0;
+        size_t literal = 0;
+        while (pos + kBlock <= size) {
+            if (out.size() + (pos - literal) > limit) {
+                return false;
+            }
+
+            uint32_t candidate = _table[hashBlock(data + pos) & _mask];
+            if (!candidate || std::memcmp(base + candidate - 1, data + pos, kBlock) != 0) {
+                ++pos;
+                continue;
+            }
+
+            size_t from = candidate - 1;
+            while (from > 0 && pos > literal && base[from - 1] == data[pos - 1]) {
+                --from;
+                --pos;
+            }
+            size_t length = 0;
+            while (from + length < baseSize && pos + length < size &&
+                   base[from + length] == data[pos + length]) {
+                ++length;
+            }
+
+            appendLiteral(out, data + literal, pos - literal);
+            appendCopy(out, from, length);
+            pos += length;
+            literal = pos;
+        }
+
+        appendLiteral(out, data + literal, size - literal);
+        return out.size() <= limit;
+    }
+
+private:
+    static void appendLiteral(std::string& out, const unsigned char* data, size_t size) {
+        while (size) {
+            size_t chunk = std::min(size, kMaxInsert);
+            out.push_back(static_cast<char>(chunk));
+            out.append(reinterpret_cast<const char*>(data), chunk);
+            data += chunk;
+            size -= chunk;
+        }
+    }
+
+    static void appendCopy(std::string& out, size_t offset, size_t size) {
+        while (size) {
+            size_t chunk = std::min(size, kMaxCopy);
+
+            unsigned char command = 0x80;
+            unsigned char operands[7];
+            size_t count = 0;
+            for (int i = 0; i < 4; ++i) {
+                unsigned char byte = static_cast<unsigned char>(offset >> (8 * i));
+                if (byte) {
+                    command |= 1 << i;
+                    operands[count++] = byte;
+                }
+            }
+            for (int i = 0; i < 3; ++i) {
+                unsigned char byte = static_cast<unsigned char>(chunk >> (8 * i));
+                if (byte) {
+                    command |= 0x10 << i;
+                    operands[count++] = byte;
+                }
+            }
+
+            out.push_back(static_cast<char>(command));
+            out.append(reinterpret_cast<const char*>(operands), count);
+            offset += chunk;
+            size -= chunk;
+        }
+    }
+
+    std::string _base;
+    std::vector<uint32_t> _table;
+    uint32_t _mask = 0;
+};
+
+git_odb* openOdb(git_repository* repo) {
+    git_odb* odb = nullptr;
+    if (git_repository_odb(&odb, repo) != 0) {
+        throw std::runtime_error("Failed to open object database: " +
+                                 std::string(git_error_last()->message));
+    }
+    return odb;
+}
+
+bool readObject(git_odb* odb, const git_oid* oid, std::string& content) {
+    git_odb_object* object = nullptr;
+    if (git_odb_read(&object, odb, oid) != 0) {
+        return false;
+    }
+    content.assign(static_cast<const char*>(git_odb_object_data(object)),
+                   git_odb_object_size(object));
+    git_odb_object_free(object);
+    return true;
+}
+
+}
+
+size_t git::PackWriter::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::PackWriter::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+git::PackWriter::PackWriter(Repository* repo, unsigned threads)
+    : _repo(repo), _threads(threads) {}
+
+git::PackWriter::~PackWriter() = default;
+
+std::unique_ptr<git::PackWriter> git::PackWriter::create(Repository* repo, unsigned threads) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::unique_ptr<PackWriter> writer(new PackWriter(repo, threads));
+    writer->_packs = PackAccess::create(repo, AccessPattern::Sequential);
+    return writer;
+}
+
+void git::PackWriter::addBranch(const Branch* branch, const Branch* base) {
+    if (!branch) {
+        throw std::invalid_argument("Branch is null.");
+    }
+
+    addRange(git_commit_id(branch->getLastCommit()->_commit),
+             base ? git_commit_id(base->getLastCommit()->_commit) : nullptr);
+}
+
+void git::PackWriter::addRange(const git_oid* tip, const git_oid* base) {
+    if (!tip) {
+        throw std::invalid_argument("Tip commit is null.");
+    }
+
+    git_revwalk* walk = nullptr;
+    if (git_revwalk_new(&walk, _repo->_repo) != 0) {
+        throw std::runtime_error("Failed to create revision walker: " +
+                                 std::string(git_error_last()->message));
+    }
+    int error = git_revwalk_sorting(walk, GIT_SORT_TIME);
+    if (error == 0) {
+        error = git_revwalk_push(walk, tip);
+    }
+    if (error == 0 && base) {
+        error = git_revwalk_hide(walk, base);
+    }
+
+    std::vector<git_oid> commits;
+    git_oid oid;
+    while (error == 0 && (error = git_revwalk_next(&oid, walk)) == 0) {
+        commits.push_back(oid);
+    }
+    git_revwalk_free(walk);
+    if (error != GIT_ITEROVER) {
+        throw std::runtime_error("Revision walk failed: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    std::unordered_set<git_oid, OidHash, OidEqual> included(commits.begin(), commits.end());
+    std::vector<git_oid> trees;
+    trees.reserve(commits.size());
+
+    for (const git_oid& id : commits) {
+        git_commit* commit = nullptr;
+        if (git_commit_lookup(&commit, _repo->_repo, &id) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+
+        // stabla roditelja van opsega su vec kod primaoca, pa se njihovi objekti preskacu
+        for (unsigned int i = 0; i < git_commit_parentcount(commit); ++i) {
+            const git_oid* parentId = git_commit_parent_id(commit, i);
+            if (included.count(*parentId) || _index.count(*parentId)) {
+                continue;
+            }
+            git_commit* parent = nullptr;
+            if (git_commit_lookup(&parent, _repo->_repo, parentId) == 0) {
+                markUninteresting(git_commit_tree_id(parent));
+                git_commit_free(parent);
+            }
+        }
+
+        trees.push_back(*git_commit_tree_id(commit));
+        git_commit_free(commit);
+        addObject(&id, GIT_OBJECT_COMMIT, "");
+    }
+
+    for (const git_oid& tree : trees) {
+        addTree(&tree, "");
+    }
+}
+
+void git::PackWriter::addObject(const git_oid* oid, git_object_t type, const std::string& path) {
+    if (_index.count(*oid)) {
+        return;
+    }
+
+    Entry entry;
+    entry.oid      = *oid;
+    entry.type     = type;
+    entry.nameHash = nameHash(path);
+    _index[*oid]   = _entries.size();
+    _entries.push_back(std::move(entry));
+}
+
+void git::PackWriter::addTree(const git_oid* oid, const std::string& path) {
+    if (!_seen.insert(*oid).second) {
+        return;
+    }
+    addObject(oid, GIT_OBJECT_TREE, path);
+
+    git_tree* tree = nullptr;
+    if (git_tree_lookup(&tree, _repo->_repo, oid) != 0) {
+        throw std::runtime_error("Failed to lookup tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    for (size_t i = 0; i < git_tree_entrycount(tree); ++i) {
+        const git_tree_entry* entry = git_tree_entry_byindex(tree, i);
+        const git_oid* id           = git_tree_entry_id(entry);
+        git_object_t type           = git_tree_entry_type(entry);
+
+        if (type == GIT_OBJECT_TREE) {
+            addTree(id, git_tree_entry_name(entry));
+        } else if (type == GIT_OBJECT_BLOB && _seen.insert(*id).second) {
+            addObject(id, GIT_OBJECT_BLOB, git_tree_entry_name(entry));
+        }
+    }
+    git_tree_free(tree);
+}
+
+void git::PackWriter::markUninteresting(const git_oid* treeId) {
+    if (!_seen.insert(*treeId).second) {
+        return;
+    }
+
+    git_tree* tree = nullptr;
+    if (git_tree_lookup(&tree, _repo->_repo, treeId) != 0) {
+        return;
+    }
+    for (size_t i = 0; i < git_tree_entrycount(tree); ++i) {
+        const git_tree_entry* entry = git_tree_entry_byindex(tree, i);
+        if (git_tree_entry_type(entry) == GIT_OBJECT_TREE) {
+            markUninteresting(git_tree_entry_id(entry));
+        } else {
+            _seen.insert(*git_tree_entry_id(entry));
+        }
+    }
+    git_tree_free(tree);
+}
+
+void git::PackWriter::planReuse() {
+    for (Entry& entry : _entries) {
+        const PackFile* pack = nullptr;
+        uint64_t offset      = 0;
+        PackFile::EntryHeader header;
+        if (!_packs->locate(&entry.oid, &pack, &offset) ||
+            !pack->readEntryHeader(offset, &header)) {
+            continue;
+        }
+
+        if (header.type != GIT_OBJECT_OFS_DELTA && header.type != GIT_OBJECT_REF_DELTA) {
+            entry.pack   = pack;
+            entry.offset = offset;
+            entry.size   = header.size;
+            entry.reuse  = true;
+            continue;
+        }
+
+        // delta se preuzima samo ako i njena baza ide u pack koji pravimo (iz bilo kog packa)
+        const unsigned char* baseOid = header.baseOid;
+        if (header.type == GIT_OBJECT_OFS_DELTA) {
+            baseOid = pack->getOidAtOffset(header.baseOffset);
+        }
+        if (!baseOid) {
+            continue;
+        }
+        git_oid base = {};
+        std::memcpy(base.id, baseOid, std::min(pack->getOidSize(), sizeof(base.id)));
+        auto found = _index.find(base);
+        if (found == _index.end()) {
+            continue;
+        }
+
+        entry.pack       = pack;
+        entry.offset     = offset;
+        entry.dataOffset = header.dataOffset;
+        entry.deltaSize  = header.size;
+        entry.base       = found->second;
+        entry.reuse      = true;
+    }
+
+    breakDeltaCycles();
+    limitDeltaDepth();
+}
+
+void git::PackWriter::breakDeltaCycles() {
+    // objekat moze biti delta na B u jednom packu, a B delta na njega u drugom; takav
+    // ciklus bi writeEntry vrteo beskonacno, pa delta koja ga zatvara postaje ceo objekat
+    enum : uint8_t { kUnvisited, kVisiting, kDone };
+    std::vector<uint8_t> state(_entries.size(), kUnvisited);
+    std::vector<size_t> chain;
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        chain.clear();
+        size_t current = i;
+        while (current != SIZE_MAX && state[current] == kUnvisited) {
+            state[current] = kVisiting;
+            chain.push_back(current);
+            current = _entries[current].base;
+        }
+        if (current != SIZE_MAX && state[current] == kVisiting) {
+            Entry& entry = _entries[chain.back()];
+            entry.pack   = nullptr;
+            entry.base   = SIZE_MAX;
+            entry.reuse  = false;
+        }
+        for (size_t index : chain) {
+            state[index] = kDone;
+        }
+    }
+}
+
+void git::PackWriter::limitDeltaDepth() {
+    // preuzeta delta nosi lanac iz svog packa, koji moze biti duzi od kMaxDepth; delta na
+    // dubini preko granice postaje ceo objekat, a dubine iznad nje se racunaju od nule
+    std::vector<bool> known(_entries.size(), false);
+    std::vector<size_t> chain;
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        chain.clear();
+        for (size_t current = i; current != SIZE_MAX && !known[current];
+             current        = _entries[current].base) {
+            chain.push_back(current);
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            Entry& entry = _entries[*it];
+            known[*it]   = true;
+            entry.depth  = entry.base == SIZE_MAX ? 0 : _entries[entry.base].depth + 1;
+            if (entry.depth > kMaxDepth) {
+                entry.pack  = nullptr;
+                entry.base  = SIZE_MAX;
+                entry.reuse = false;
+                entry.depth = 0;
+            }
+        }
+    }
+}
+
+void git::PackWriter::searchDeltas() {
+    git_odb* odb = openOdb(_repo->_repo);
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        Entry& entry = _entries[i];
+        if (entry.reuse) {
+            continue;
+        }
+        git_object_t type = GIT_OBJECT_INVALID;
+        size_t size       = 0;
+        if (git_odb_read_header(&size, &type, odb, &entry.oid) != 0) {
+            git_odb_free(odb);
+            throw std::runtime_error("Failed to read object header: " +
+                                     std::string(git_error_last()->message));
+        }
+        entry.size = size;
+        candidates.push_back(i);
+    }
+    if (candidates.empty()) {
+        git_odb_free(odb);
+        return;
+    }
+
+    // slicni objekti (isti tip, slicna putanja) zavrsavaju jedan do drugog u prozoru
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        const Entry& x = _entries[a];
+        const Entry& y = _entries[b];
+        if (x.type != y.type) {
+            return x.type < y.type;
+        }
+        if (x.nameHash != y.nameHash) {
+            return x.nameHash < y.nameHash;
+        }
+        return x.size > y.size;
+    });
+
+    // baza preuzete delte ostaje ceo objekat: nova delta ispod nje bi produzila lanac
+    // preko kMaxDepth
+    std::vector<bool> reusedBase(_entries.size(), false);
+    for (const Entry& entry : _entries) {
+        if (entry.reuse && entry.base != SIZE_MAX) {
+            reusedBase[entry.base] = true;
+        }
+    }
+
+    std::unique_ptr<CompressionBackend> compression = CompressionBackend::createDefault();
+    std::mutex errorMutex;
+    std::string error;
+
+    std::unique_ptr<TaskScheduler> scheduler = TaskScheduler::create(_repo, _threads);
+    auto work = [&](size_t begin, size_t end) {
+        // odb handle niti, da se citanja iz razlicitih niti ne bore oko istog kesa
+        git_odb* odb = openOdb(scheduler->getThreadRepository());
+        std::unique_ptr<git_odb, decltype(&git_odb_free)> odbGuard(odb, &git_odb_free);
+
+        struct WindowEntry {
+            size_t entry;
+            std::unique_ptr<DeltaIndex> index;
+        };
+        std::deque<WindowEntry> window;
+        std::string content, delta;
+
+        for (size_t c = begin; c < end; ++c) {
+            Entry& entry = _entries[candidates[c]];
+            if (entry.size < kMinDeltaInput || entry.size > kMaxDeltaSize) {
+                continue;
+            }
+            if (!readObject(odb, &entry.oid, content)) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty()) {
+                    error = "Failed to read object: " + std::string(git_error_last()->message);
+                }
+                return;
+            }
+
+            size_t limit = content.size() / 2 - 20;
+            size_t best  = SIZE_MAX;
+            for (const WindowEntry& candidate : window) {
+                const Entry& base = _entries[candidate.entry];
+                if (reusedBase[candidates[c]] || base.type != entry.type ||
+                    base.depth >= kMaxDepth || candidate.index->size() < content.size() / 32) {
+                    continue;
+                }
+                if (candidate.index->encode(content, std::min(limit, best - 1), delta)) {
+                    best            = delta.size();
+                    entry.base      = candidate.entry;
+                    entry.depth     = base.depth + 1;
+                    entry.deltaSize = delta.size();
+                    compression->compress(reinterpret_cast<const unsigned char*>(delta.data()),
+                                          delta.size(), kCompressionLevel, entry.delta);
+                }
+            }
+
+            window.push_back({candidates[c], std::unique_ptr<DeltaIndex>(
+                                                 new DeltaIndex(std::move(content)))});
+            if (window.size() > kWindow) {
+                window.pop_front();
+            }
+            content.clear();
+        }
+    };
+
+    // svaki deo je neprekidan komad sortirane liste, pa prozori ostaju lokalni; delovi
+    // idu na niti scheduler-a, svaka sa svojim git_repository handle-om
+    size_t count = std::min<size_t>(_threads, std::max<size_t>(1, candidates.size() / kWindow));
+    size_t slice = (candidates.size() + count - 1) / std::max<size_t>(count, 1);
+    git_odb_free(odb);
+    scheduler->parallelFor(candidates.size(), slice, work);
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+void git::PackWriter::write(const Sink& sink) {
+    if (_entries.empty()) {
+        throw std::logic_error("Pack has no objects.");
+    }
+
+    planReuse();
+    searchDeltas();
+
+    auto hasher                 = ObjectHasher::create(ObjectHasher::detectAlgorithm(_repo));
+    ObjectHasher::Stream stream = hasher->createStream();
+    uint64_t offset             = 0;
+    _stats                      = Stats();
+
+    Sink hashed = [&](const void* data, size_t size) {
+        stream.update(data, size);
+        sink(data, size);
+        offset += size;
+    };
+
+    unsigned char header[12] = {'P', 'A', 'C', 'K', 0, 0, 0, 2};
+    uint32_t count           = static_cast<uint32_t>(_entries.size());
+    for (int i = 0; i < 4; ++i) {
+        header[8 + i] = static_cast<unsigned char>(count >> (24 - 8 * i));
+    }
+    hashed(header, sizeof(header));
+
+    // ceo objekti koji se ne preuzimaju citaju se kroz jedan ODB handle i jedan kompresor
+    git_odb* odb = openOdb(_repo->_repo);
+    std::unique_ptr<git_odb, decltype(&git_odb_free)> odbGuard(odb, &git_odb_free);
+    std::unique_ptr<CompressionBackend> compression = CompressionBackend::createDefault();
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        writeEntry(i, hashed, &offset, odb, compression.get());
+    }
+
+    unsigned char digest[ObjectHasher::kMaxDigestSize];
+    stream.finish(digest);
+    sink(digest, hasher->getDigestSize());
+
+    _stats.objects = _entries.size();
+    _stats.bytes   = offset + hasher->getDigestSize();
+}
+
+void git::PackWriter::writeEntry(size_t index, const Sink& sink, uint64_t* offset, git_odb* odb,
+                                 CompressionBackend* compression) {
+    Entry& entry = _entries[index];
+    if (entry.written) {
+        return;
+    }
+    // baza se pise pre delte, pa je uvek moguc OFS_DELTA
+    if (entry.base != SIZE_MAX) {
+        writeEntry(entry.base, sink, offset, odb, compression);
+    }
+    entry.writtenOffset = *offset;
+    entry.written       = true;
+
+    unsigned char header[32];
+    if (entry.base != SIZE_MAX) {
+        size_t length = encodeEntryHeader(GIT_OBJECT_OFS_DELTA, entry.deltaSize, header);
+        length += encodeDeltaOffset(*offset - _entries[entry.base].writtenOffset,
+                                    header + length);
+        sink(header, length);
+
+        if (entry.reuse) {
+            uint64_t end = entry.offset + entry.pack->getEntryLength(entry.offset);
+            sink(entry.pack->getData() + entry.dataOffset, end - entry.dataOffset);
+            ++_stats.reusedDeltas;
+        } else {
+            sink(entry.delta.data(), entry.delta.size());
+            std::string().swap(entry.delta);
+            ++_stats.newDeltas;
+        }
+        return;
+    }
+
+    if (entry.reuse) {
+        sink(entry.pack->getData() + entry.offset, entry.pack->getEntryLength(entry.offset));
+        ++_stats.reusedWhole;
+        return;
+    }
+
+    std::string content;
+    if (!readObject(odb, &entry.oid, content)) {
+        throw std::runtime_error("Failed to read object: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    std::string compressed;
+    compression->compress(reinterpret_cast<const unsigned char*>(content.data()), content.size(),
+                          kCompressionLevel, compressed);
+
+    sink(header, encodeEntryHeader(entry.type, content.size(), header));
+    sink(compressed.data(), compressed.size());
+}
+
+void git::PackWriter::writeFile(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    write([&out](const void* data, size_t size) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    });
+
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+size_t git::PackWriter::getObjectCount() const {
+    return _entries.size();
+}
+
+const git::PackWriter::Stats& git::PackWriter::getStats() const {
+    return _stats;
+}
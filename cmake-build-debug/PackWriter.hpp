@@ -0,0 +1,112 @@
+#ifndef PROBA_PACKWRITER_HPP
+#define PROBA_PACKWRITER_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class CompressionBackend;
+class PackAccess;
+class PackFile;
+class Repository;
+
+// pack sa istorijom grane (bez objekata dostupnih iz baze); postojece delte se preuzimaju
+// direktno iz packova, a nove se racunaju paralelno u kliznom prozoru
+class PackWriter {
+public:
+    typedef std::function<void(const void* data, size_t size)> Sink;
+
+    static constexpr size_t kWindow        = 10;
+    static constexpr unsigned kMaxDepth    = 50;
+    static constexpr size_t kMaxDeltaSize  = 512ull * 1024 * 1024;
+    static constexpr int kCompressionLevel = 6;
+
+    struct Stats {
+        size_t objects      = 0;
+        size_t reusedWhole  = 0;
+        size_t reusedDeltas = 0;
+        size_t newDeltas    = 0;
+        uint64_t bytes      = 0;
+    };
+
+    PackWriter(const PackWriter&)            = delete;
+    PackWriter& operator=(const PackWriter&) = delete;
+    ~PackWriter();
+
+    static std::unique_ptr<PackWriter> create(Repository* repo, unsigned threads = 0);
+
+    void addBranch(const Branch* branch, const Branch* base = nullptr);
+    void addRange(const git_oid* tip, const git_oid* base);
+
+    void write(const Sink& sink);
+    void writeFile(const std::string& path);
+
+    size_t getObjectCount() const;
+    const Stats& getStats() const;
+
+private:
+    struct Entry {
+        git_oid oid;
+        git_object_t type;
+        uint32_t nameHash = 0;
+        uint64_t size     = 0;
+
+        // izvor za preuzimanje postojeceg zapisa iz packa
+        const PackFile* pack = nullptr;
+        uint64_t offset      = 0;
+        uint64_t dataOffset  = 0;
+        bool reuse           = false;
+
+        size_t base        = SIZE_MAX;
+        unsigned depth     = 0;
+        uint64_t deltaSize = 0;
+        std::string delta;
+
+        bool written           = false;
+        uint64_t writtenOffset = 0;
+    };
+
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+
+    PackWriter(Repository* repo, unsigned threads);
+
+    void addObject(const git_oid* oid, git_object_t type, const std::string& path);
+    void addTree(const git_oid* oid, const std::string& path);
+    void markUninteresting(const git_oid* treeId);
+
+    void planReuse();
+    void breakDeltaCycles();
+    void limitDeltaDepth();
+    void searchDeltas();
+    void writeEntry(size_t index, const Sink& sink, uint64_t* offset, git_odb* odb,
+                    CompressionBackend* compression);
+
+    Repository* _repo;
+    unsigned _threads;
+    std::unique_ptr<PackAccess> _packs;
+
+    std::vector<Entry> _entries;
+    std::unordered_map<git_oid, size_t, OidHash, OidEqual> _index;
+    std::unordered_set<git_oid, OidHash, OidEqual> _seen;
+
+    Stats _stats;
+};
+
+}
+
+#endif
@@ -0,0 +1,353 @@
+#include "ReflogIndex.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+void makeDirectories(const std::string& path) {
+    if (path.empty() || mkdir(path.c_str(), 0777) == 0 || errno == EEXIST) {
+        return;
+    }
+    if (errno != ENOENT) {
+        throw std::runtime_error("Failed to create directory " + path + ": " +
+                                 std::strerror(errno));
+    }
+
+    makeDirectories(parentOf(path));
+    if (mkdir(path.c_str(), 0777) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create directory " + path + ": " +
+                                 std::strerror(errno));
+    }
+}
+
+// u povezanom worktree-u samo HEAD i refs/{bisect,worktree,rewritten}/ imaju reflog u
+// sopstvenom git direktorijumu; ostale reference (refs/heads/...) su u zajednickom
+std::string reflogPath(git_repository* repo, const std::string& refName) {
+    bool perWorktree = refName.compare(0, 5, "refs/") != 0 ||
+                       refName.compare(0, 12, "refs/bisect/") == 0 ||
+                       refName.compare(0, 14, "refs/worktree/") == 0 ||
+                       refName.compare(0, 15, "refs/rewritten/") == 0;
+    const char* base = perWorktree ? git_repository_path(repo) : git_repository_commondir(repo);
+    return std::string(base) + "logs/" + refName;
+}
+
+// mtime u nanosekundama, 0 ako fajl ne postoji
+int64_t modificationTime(const std::string& path, size_t* size = nullptr) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+    if (size) {
+        *size = static_cast<size_t>(st.st_size);
+    }
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+void writeAll(int fd, const void* data, size_t size, const std::string& path) {
+    const char* p = static_cast<const char*>(data);
+    while (size) {
+        ssize_t written = ::write(fd, p, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw std::runtime_error("Failed to write " + path + ": " + std::strerror(errno));
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void fillHeader(unsigned char* header) {
+    uint32_t fields[4] = {git::ReflogIndex::kMagic, git::ReflogIndex::kVersion,
+                          static_cast<uint32_t>(sizeof(git::ReflogIndex::Record)), 0};
+    std::memcpy(header, fields, sizeof(fields));
+}
+
+bool isZero(const unsigned char* id) {
+    for (size_t i = 0; i < sizeof(git_oid().id); ++i) {
+        if (id[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+git::ReflogIndex::ReflogIndex(Repository* repo) : _repo(repo) {}
+
+git::ReflogIndex::~ReflogIndex() {
+    for (auto& entry : _mappings) {
+        if (entry.second.data) {
+            munmap(const_cast<unsigned char*>(entry.second.data), entry.second.size);
+        }
+    }
+}
+
+std::unique_ptr<git::ReflogIndex> git::ReflogIndex::create(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    return std::unique_ptr<ReflogIndex>(new ReflogIndex(repo));
+}
+
+std::string git::ReflogIndex::getIndexPath(Repository* repo, const std::string& refName) {
+    return std::string(git_repository_path(repo->_repo)) + kIndexDirectory + refName;
+}
+
+void git::ReflogIndex::record(Repository* repo, const std::string& refName, const git_oid* oid) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    // reflog vec sadrzi ovu izmenu kao najnoviji unos; njegovo vreme je i vreme zapisa, isto
+    // kao pri gradjenju indeksa iz reflog-a
+    Record newest               = {};
+    std::vector<Record> records = readReflog(repo, refName, &newest);
+    std::string path            = getIndexPath(repo, refName);
+    if (records.empty()) {
+        return;
+    }
+    if (std::memcmp(newest.id, oid->id, std::min(sizeof(oid->id), sizeof(newest.id))) != 0) {
+        writeRecords(path, records);
+        return;
+    }
+
+    // dopisuje se samo ako indeks vec ima sve ostale unose reflog-a; inace je reflog menjan
+    // mimo Branch-a (npr. git CLI) i indeks se gradi iznova, jer bi dopisani zapis bio
+    // noviji od reflog-a i map() ga vise ne bi osvezio
+    int fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        writeRecords(path, records);
+        return;
+    }
+
+    struct stat st;
+    Record last    = {};
+    bool appending = fstat(fd, &st) == 0 &&
+                     static_cast<size_t>(st.st_size) ==
+                         kHeaderSize + (records.size() - 1) * sizeof(Record);
+    if (appending && records.size() > 1) {
+        // newest je najnoviji, pa je posle sortiranja poslednji; pre njega je poslednji
+        // zapis indeksa, ako indeks nije zastareo
+        const Record& previous = records[records.size() - 2];
+        appending = records.back().time == newest.time &&
+                    pread(fd, &last, sizeof(last),
+                          st.st_size - static_cast<off_t>(sizeof(last))) ==
+                        static_cast<ssize_t>(sizeof(last)) &&
+                    last.time == previous.time &&
+                    std::memcmp(last.id, previous.id, sizeof(last.id)) == 0;
+    }
+
+    if (!appending) {
+        ::close(fd);
+        writeRecords(path, records);
+        return;
+    }
+
+    try {
+        writeAll(fd, &newest, sizeof(newest), path);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+std::vector<git::ReflogIndex::Record> git::ReflogIndex::readReflog(Repository* repo,
+                                                                   const std::string& refName,
+                                                                   Record* newest) {
+    git_reflog* reflog = nullptr;
+    if (git_reflog_read(&reflog, repo->_repo, refName.c_str()) != 0) {
+        throw std::runtime_error("Failed to read reflog of " + refName + ": " +
+                                 std::string(git_error_last()->message));
+    }
+
+    // reflog je od najnovijeg ka najstarijem
+    size_t count = git_reflog_entrycount(reflog);
+    std::vector<Record> records(count);
+    for (size_t i = 0; i < count; ++i) {
+        const git_reflog_entry* entry = git_reflog_entry_byindex(reflog, count - 1 - i);
+        const git_oid* id             = git_reflog_entry_id_new(entry);
+
+        Record& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        record.time = git_reflog_entry_committer(entry)->when.time;
+        std::memcpy(record.id, id->id, std::min(sizeof(id->id), sizeof(record.id)));
+    }
+    git_reflog_free(reflog);
+    if (newest && count) {
+        *newest = records.back();
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record& a, const Record& b) { return a.time < b.time; });
+    return records;
+}
+
+void git::ReflogIndex::writeRecords(const std::string& path, const std::vector<Record>& records) {
+    makeDirectories(parentOf(path));
+
+    std::string temporary = path + ".lock";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + temporary + ": " + std::strerror(errno));
+    }
+
+    try {
+        unsigned char header[kHeaderSize];
+        fillHeader(header);
+        writeAll(fd, header, sizeof(header), temporary);
+        writeAll(fd, records.data(), records.size() * sizeof(Record), temporary);
+    } catch (...) {
+        ::close(fd);
+        unlink(temporary.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + temporary + " to " + path);
+    }
+}
+
+void git::ReflogIndex::rebuild(const std::string& refName) {
+    writeRecords(getIndexPath(_repo, refName), readReflog(_repo, refName));
+}
+
+void git::ReflogIndex::rebuildAll() {
+    for (const auto& branch : Branch::getAllBranches(_repo)) {
+        rebuild(git_reference_name(branch->_branch));
+    }
+}
+
+const git::ReflogIndex::Mapping* git::ReflogIndex::map(const std::string& refName) const {
+    std::string path = getIndexPath(_repo, refName);
+    std::string log  = reflogPath(_repo->_repo, refName);
+
+    // reflog izmenjen mimo Branch-a: indeks te reference je zastareo
+    size_t size      = 0;
+    int64_t indexed  = modificationTime(path, &size);
+    int64_t modified = modificationTime(log);
+    if (modified > indexed) {
+        writeRecords(path, readReflog(_repo, refName));
+        indexed = modificationTime(path, &size);
+    }
+    if (!indexed || size < kHeaderSize) {
+        return nullptr;
+    }
+
+    Mapping& mapping = _mappings[refName];
+    if (mapping.data && mapping.mtime == indexed && mapping.size == size) {
+        return &mapping;
+    }
+    if (mapping.data) {
+        munmap(const_cast<unsigned char*>(mapping.data), mapping.size);
+        mapping = Mapping();
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map " + path + ": " + std::strerror(errno));
+    }
+    madvise(data, size, MADV_RANDOM);
+
+    uint32_t header[4];
+    std::memcpy(header, data, sizeof(header));
+    if (header[0] != kMagic || header[1] != kVersion || header[2] != sizeof(Record)) {
+        munmap(data, size);
+        throw std::runtime_error("Unsupported reflog index " + path);
+    }
+
+    mapping.data  = static_cast<const unsigned char*>(data);
+    mapping.size  = size;
+    mapping.mtime = indexed;
+    return &mapping;
+}
+
+bool git::ReflogIndex::lookup(const std::string& refName, int64_t time, git_oid* oid) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const Mapping* mapping = map(refName);
+    if (!mapping) {
+        return false;
+    }
+
+    const Record* begin = reinterpret_cast<const Record*>(mapping->data + kHeaderSize);
+    const Record* end   = begin + (mapping->size - kHeaderSize) / sizeof(Record);
+    const Record* found = std::upper_bound(
+        begin, end, time, [](int64_t value, const Record& record) { return value < record.time; });
+
+    // nula OID znaci da je grana u tom trenutku bila obrisana
+    if (found == begin || isZero((found - 1)->id)) {
+        return false;
+    }
+    std::memset(oid, 0, sizeof(*oid));
+    std::memcpy(oid->id, (found - 1)->id, std::min(sizeof(oid->id), sizeof(found->id)));
+    return true;
+}
+
+std::map<std::string, git_oid> git::ReflogIndex::getTipsAt(int64_t time) const {
+    std::vector<std::string> refs;
+    listRefs(std::string(git_repository_path(_repo->_repo)) + kIndexDirectory, "", refs);
+
+    std::map<std::string, git_oid> tips;
+    for (const std::string& ref : refs) {
+        git_oid oid;
+        if (lookup(ref, time, &oid)) {
+            tips[ref] = oid;
+        }
+    }
+    return tips;
+}
+
+void git::ReflogIndex::listRefs(const std::string& directory, const std::string& prefix,
+                                std::vector<std::string>& refs) const {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return;
+    }
+
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == ".." ||
+            (name.size() > 5 && name.compare(name.size() - 5, 5, ".lock") == 0)) {
+            continue;
+        }
+
+        struct stat st;
+        std::string path = directory + name;
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            listRefs(path + "/", prefix + name + "/", refs);
+        } else {
+            refs.push_back(prefix + name);
+        }
+    }
+    closedir(dir);
+}
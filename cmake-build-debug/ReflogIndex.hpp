@@ -0,0 +1,80 @@
+#ifndef PROBA_REFLOGINDEX_HPP
+#define PROBA_REFLOGINDEX_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// indeks reflog-a po referenci: niz zapisa (vreme, OID) sortiran po vremenu, citan preko
+// mmap-a, pa je "vrh grane u trenutku T" binarna pretraga umesto parsiranja teksta;
+// Branch dopisuje zapis posle svakog azuriranja, a izmene mimo Branch-a (npr. git CLI)
+// se otkrivaju po mtime-u reflog fajla i indeks te reference se gradi iznova
+class ReflogIndex {
+public:
+    static constexpr const char* kIndexDirectory = "proba-reflog-index/";
+    static constexpr uint32_t kMagic             = 0x50524c58;
+    static constexpr uint32_t kVersion           = 1;
+    static constexpr size_t kHeaderSize          = 16;
+
+    struct Record {
+        int64_t time;
+        unsigned char id[32];
+    };
+
+    ReflogIndex(const ReflogIndex&)            = delete;
+    ReflogIndex& operator=(const ReflogIndex&) = delete;
+    ~ReflogIndex();
+
+    static std::unique_ptr<ReflogIndex> create(Repository* repo);
+
+    // dopisuje najnoviji unos reflog-a reference (npr. "refs/heads/main"), koji mora biti
+    // izmena na oid; ako indeks nema sve prethodne unose ili zapis ne bi bio poslednji po
+    // vremenu, indeks te reference se gradi iznova iz reflog-a
+    static void record(Repository* repo, const std::string& refName, const git_oid* oid);
+
+    void rebuild(const std::string& refName);
+    void rebuildAll();
+
+    // vrh reference u trenutku time; false ako referenca tada nije postojala
+    bool lookup(const std::string& refName, int64_t time, git_oid* oid) const;
+
+    // vrhovi svih indeksiranih referenci u trenutku time, ukljucujuci i obrisane grane
+    std::map<std::string, git_oid> getTipsAt(int64_t time) const;
+
+private:
+    struct Mapping {
+        const unsigned char* data = nullptr;
+        size_t size               = 0;
+        int64_t mtime             = 0;
+    };
+
+    explicit ReflogIndex(Repository* repo);
+
+    static std::string getIndexPath(Repository* repo, const std::string& refName);
+    // newest: poslednji dopisan unos, pre sortiranja po vremenu
+    static std::vector<Record> readReflog(Repository* repo, const std::string& refName,
+                                          Record* newest = nullptr);
+    static void writeRecords(const std::string& path, const std::vector<Record>& records);
+
+    const Mapping* map(const std::string& refName) const;
+    void listRefs(const std::string& directory, const std::string& prefix,
+                  std::vector<std::string>& refs) const;
+
+    Repository* _repo;
+    mutable std::mutex _mutex;
+    mutable std::map<std::string, Mapping> _mappings;
+};
+
+}
+
+#endif
@@ -0,0 +1,299 @@
+#include "SubmoduleCheckout.hpp"
+
+#include "BatchCheckout.hpp"
+#include "Branch.hpp"
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+// init upisuje submodule.<ime>.url u .git/config superprojekta; paralelni upisi bi se
+// sudarili na config.lock (GIT_ELOCKED), pa init ide serijski, a clone/fetch/checkout ne
+std::mutex configMutex;
+
+// bez pretrage navise: prazan direktorijum neinicijalizovanog submodula ne sme da
+// otvori superprojekat
+git_repository* openExact(const std::string& path) {
+    git_repository* repo = nullptr;
+    if (git_repository_open_ext(&repo, path.c_str(), GIT_REPOSITORY_OPEN_NO_SEARCH, nullptr) !=
+        0) {
+        return nullptr;
+    }
+    return repo;
+}
+
+std::string describe(const std::string& path, const std::string& message) {
+    return "Submodule " + path + ": " + message;
+}
+
+// kloniranje (init) ili fetch preko libgit2, sa konfiguracijom iz .gitmodules superprojekta
+void updateFromParent(const std::string& parent, const std::string& path, bool init) {
+    git_repository* repo = openExact(parent);
+    if (!repo) {
+        throw std::runtime_error(describe(path, "failed to open parent repository: " +
+                                                    std::string(git_error_last()->message)));
+    }
+
+    git_submodule* submodule = nullptr;
+    int error                = git_submodule_lookup(&submodule, repo, path.c_str());
+    if (error == 0 && init) {
+        std::lock_guard<std::mutex> lock(configMutex);
+        error = git_submodule_init(submodule, 0);
+    }
+    if (error == 0) {
+        git_submodule_update_options opts = GIT_SUBMODULE_UPDATE_OPTIONS_INIT;
+        opts.checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+        opts.allow_fetch                     = 1;
+        error = git_submodule_update(submodule, 0, &opts);
+    }
+    git_submodule_free(submodule);
+    git_repository_free(repo);
+
+    if (error != 0) {
+        throw std::runtime_error(describe(path, git_error_last()->message));
+    }
+}
+
+// isti redosled kao Branch::checkout: BatchCheckout kada moze, inace SAFE checkout
+void checkoutCommit(git_repository* repo, git_commit* commit, const std::string& path,
+                    const std::shared_ptr<git::TaskScheduler>& scheduler) {
+    auto batch = git::BatchCheckout::create(repo, commit, scheduler);
+    if (batch->isApplicable()) {
+        batch->run();
+    } else {
+        git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+        opts.checkout_strategy    = GIT_CHECKOUT_SAFE;
+        if (git_checkout_tree(repo, reinterpret_cast<const git_object*>(commit), &opts) != 0) {
+            throw std::runtime_error(
+                describe(path, "checkout failed: " + std::string(git_error_last()->message)));
+        }
+    }
+
+    if (git_repository_set_head_detached(repo, git_commit_id(commit)) != 0) {
+        throw std::runtime_error(
+            describe(path, "could not update HEAD: " + std::string(git_error_last()->message)));
+    }
+}
+
+}
+
+git::SubmoduleCheckout::SubmoduleCheckout(Repository* repo, unsigned jobs, bool recursive)
+    : _repo(repo), _jobs(jobs), _recursive(recursive) {}
+
+git::SubmoduleCheckout::~SubmoduleCheckout() = default;
+
+std::unique_ptr<git::SubmoduleCheckout> git::SubmoduleCheckout::create(
+    Repository* repo, unsigned jobs, bool recursive, std::shared_ptr<TaskScheduler> scheduler) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    std::unique_ptr<SubmoduleCheckout> checkout(new SubmoduleCheckout(repo, jobs, recursive));
+    checkout->_scheduler = std::move(scheduler);
+    return checkout;
+}
+
+void git::SubmoduleCheckout::checkout(Branch* branch, const Branch* target) {
+    if (!branch || !target) {
+        throw std::invalid_argument("Branch is null.");
+    }
+
+    branch->checkout(target);
+    update(target->getLastCommit()->_commit);
+}
+
+void git::SubmoduleCheckout::update(git_commit* target) {
+    if (!target) {
+        throw std::invalid_argument("Target commit is null.");
+    }
+
+    const char* workdir = git_repository_workdir(_repo->_repo);
+    if (!workdir) {
+        throw std::runtime_error("Cannot check out submodules in a bare repository.");
+    }
+
+    git_tree* tree = nullptr;
+    if (git_commit_tree(&tree, target) != 0) {
+        throw std::runtime_error("Failed to read target tree: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    _queue.clear();
+    _results.clear();
+    _error.clear();
+    _running = 0;
+    _limit   = 0;
+    try {
+        enqueue(workdir, tree, "");
+    } catch (...) {
+        git_tree_free(tree);
+        throw;
+    }
+    git_tree_free(tree);
+
+    if (_queue.empty()) {
+        return;
+    }
+    if (!_scheduler) {
+        _scheduler = TaskScheduler::create(_repo);
+    }
+
+    // svaki submodul je zaseban posao na scheduler-u superprojekta, a novi se salju tek kada
+    // se pojave u redu, pa nijedna nit scheduler-a ne ceka na posao; ugnjezdeni checkout-i i
+    // citanja unapred dobijaju slobodne niti
+    std::unique_lock<std::mutex> lock(_mutex);
+    _limit = _jobs ? _jobs : _scheduler->getThreadCount();
+    dispatch();
+    _done.wait(lock, [this]() { return _running == 0 && (_queue.empty() || !_error.empty()); });
+
+    if (!_error.empty()) {
+        throw std::runtime_error(_error);
+    }
+}
+
+const std::vector<git::SubmoduleCheckout::Result>& git::SubmoduleCheckout::getResults() const {
+    return _results;
+}
+
+void git::SubmoduleCheckout::enqueue(const std::string& parent, git_tree* tree,
+                                     const std::string& prefix) {
+    std::vector<Job> found;
+    std::vector<std::pair<git_oid, std::string>> subtrees;
+
+    for (size_t i = 0; i < git_tree_entrycount(tree); ++i) {
+        const git_tree_entry* entry = git_tree_entry_byindex(tree, i);
+        std::string path            = prefix + git_tree_entry_name(entry);
+
+        git_filemode_t mode = git_tree_entry_filemode(entry);
+        if (mode == GIT_FILEMODE_COMMIT) {
+            found.push_back({parent, path, *git_tree_entry_id(entry)});
+        } else if (mode == GIT_FILEMODE_TREE) {
+            subtrees.emplace_back(*git_tree_entry_id(entry), path + "/");
+        }
+    }
+
+    if (!found.empty()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.insert(_queue.end(), found.begin(), found.end());
+        dispatch();
+    }
+
+    for (const auto& subtree : subtrees) {
+        git_tree* child = nullptr;
+        if (git_tree_lookup(&child, git_tree_owner(tree), &subtree.first) != 0) {
+            throw std::runtime_error("Failed to lookup tree " + subtree.second + ": " +
+                                     std::string(git_error_last()->message));
+        }
+        try {
+            enqueue(parent, child, subtree.second);
+        } catch (...) {
+            git_tree_free(child);
+            throw;
+        }
+        git_tree_free(child);
+    }
+}
+
+void git::SubmoduleCheckout::dispatch() {
+    // poziva se pod _mutex-om; posle greske se novi poslovi ne pokrecu
+    while (_running < _limit && _error.empty() && !_queue.empty()) {
+        Job job = std::move(_queue.front());
+        _queue.pop_front();
+        ++_running;
+        _scheduler->submit([this, job]() { run(job); });
+    }
+}
+
+void git::SubmoduleCheckout::run(const Job& job) {
+    std::string error;
+    try {
+        process(job);
+    } catch (const std::exception& e) {
+        error = e.what();
+    } catch (...) {
+        error = describe(job.path, "checkout failed");
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!error.empty() && _error.empty()) {
+        _error = error;
+    }
+    --_running;
+    dispatch();
+    if (_running == 0) {
+        _done.notify_all();
+    }
+}
+
+git_repository* git::SubmoduleCheckout::openSubmodule(const Job& job, bool* cloned) {
+    *cloned              = false;
+    git_repository* repo = openExact(job.parent + job.path);
+    if (repo) {
+        return repo;
+    }
+
+    updateFromParent(job.parent, job.path, true);
+    *cloned = true;
+
+    repo = openExact(job.parent + job.path);
+    if (!repo) {
+        throw std::runtime_error(describe(job.path, "failed to open after clone: " +
+                                                        std::string(git_error_last()->message)));
+    }
+    return repo;
+}
+
+void git::SubmoduleCheckout::process(const Job& job) {
+    bool cloned          = false;
+    git_repository* repo = openSubmodule(job, &cloned);
+
+    git_commit* commit = nullptr;
+    if (git_commit_lookup(&commit, repo, &job.commit) != 0 && !cloned) {
+        // commit jos nije preuzet; libgit2 ga dohvata sa remote-a submodula
+        git_repository_free(repo);
+        updateFromParent(job.parent, job.path, false);
+        repo = openExact(job.parent + job.path);
+        if (!repo || git_commit_lookup(&commit, repo, &job.commit) != 0) {
+            commit = nullptr;
+        }
+    }
+    if (!commit) {
+        char hex[GIT_OID_HEXSZ + 1] = {};
+        git_oid_fmt(hex, &job.commit);
+        git_repository_free(repo);
+        throw std::runtime_error(describe(job.path, "commit " + std::string(hex) +
+                                                        " is not available"));
+    }
+
+    std::string workdir = job.parent + job.path + "/";
+    try {
+        checkoutCommit(repo, commit, job.path, _scheduler);
+
+        if (_recursive) {
+            git_tree* tree = nullptr;
+            if (git_commit_tree(&tree, commit) != 0) {
+                throw std::runtime_error(
+                    describe(job.path, "failed to read tree: " +
+                                           std::string(git_error_last()->message)));
+            }
+            try {
+                enqueue(workdir, tree, "");
+            } catch (...) {
+                git_tree_free(tree);
+                throw;
+            }
+            git_tree_free(tree);
+        }
+    } catch (...) {
+        git_commit_free(commit);
+        git_repository_free(repo);
+        throw;
+    }
+    git_commit_free(commit);
+    git_repository_free(repo);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _results.push_back({job.parent + job.path, job.commit, cloned});
+}
@@ -0,0 +1,81 @@
+#ifndef PROBA_SUBMODULECHECKOUT_HPP
+#define PROBA_SUBMODULECHECKOUT_HPP
+
+#include <git2.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class Repository;
+class TaskScheduler;
+
+// checkout submodula iz gitlink-ova ciljnog stabla; submoduli se obradjuju paralelno
+// (najvise jobs odjednom), svaki kroz isti put kao Branch::checkout (BatchCheckout ili
+// SAFE checkout), a ugnjezdeni submoduli idu u isti red posla
+class SubmoduleCheckout {
+public:
+    struct Result {
+        std::string path;
+        git_oid commit;
+        bool cloned = false;
+    };
+
+    SubmoduleCheckout(const SubmoduleCheckout&)            = delete;
+    SubmoduleCheckout& operator=(const SubmoduleCheckout&) = delete;
+    ~SubmoduleCheckout();
+
+    // poslovi idu na scheduler pozivaoca; bez njega update() pravi sopstveni, i to samo
+    // ako stablo ima submodule; jobs = 0 znaci broj niti scheduler-a
+    static std::unique_ptr<SubmoduleCheckout> create(
+        Repository* repo, unsigned jobs = 0, bool recursive = true,
+        std::shared_ptr<TaskScheduler> scheduler = nullptr);
+
+    // branch->checkout(target), pa submoduli iz stabla target grane
+    void checkout(Branch* branch, const Branch* target);
+
+    // radni direktorijum superprojekta mora vec odgovarati target commit-u
+    void update(git_commit* target);
+
+    const std::vector<Result>& getResults() const;
+
+private:
+    struct Job {
+        std::string parent;
+        std::string path;
+        git_oid commit;
+    };
+
+    SubmoduleCheckout(Repository* repo, unsigned jobs, bool recursive);
+
+    void enqueue(const std::string& parent, git_tree* tree, const std::string& prefix);
+    void dispatch();
+    void run(const Job& job);
+    void process(const Job& job);
+
+    git_repository* openSubmodule(const Job& job, bool* cloned);
+
+    Repository* _repo;
+    unsigned _jobs;
+    bool _recursive;
+    std::shared_ptr<TaskScheduler> _scheduler;
+
+    std::mutex _mutex;
+    std::condition_variable _done;
+    std::deque<Job> _queue;
+    size_t _running = 0;
+    size_t _limit   = 0;
+    std::string _error;
+    std::vector<Result> _results;
+};
+
+}
+
+#endif
@@ -0,0 +1,300 @@
+#include "Tag.hpp"
+
+#include "Branch.hpp"
+#include "CancellationToken.hpp"
+#include "CommitGraph.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+struct WalkEntry {
+    uint32_t generation;
+    int64_t time;
+    git_oid id;
+
+    // najveca generacija prva; bez commit-graph-a (beskonacna generacija) odlucuje vreme
+    bool operator<(const WalkEntry& other) const {
+        if (generation != other.generation) {
+            return generation < other.generation;
+        }
+        return time < other.time;
+    }
+};
+
+}
+
+size_t git::Tag::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::Tag::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+git::Tag::Tag(git_reference* tag, Repository* repo, const Peeled& peeled)
+    : _tag(tag), _repo(repo), _peeled(peeled) {}
+
+git::Tag::~Tag() {
+    git_reference_free(_tag);
+}
+
+std::unique_ptr<git::Tag> git::Tag::create(git_reference* tag, Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (!tag || !git_reference_target(tag)) {
+        throw std::invalid_argument("Tag reference is null or symbolic.");
+    }
+    Peeled peeled = peel(repo->_repo, git_reference_target(tag));
+    return std::unique_ptr<Tag>(new Tag(tag, repo, peeled));
+}
+
+std::string git::Tag::getTagName() const {
+    return git_reference_shorthand(_tag);
+}
+
+git::Repository* git::Tag::getRepository() const {
+    return _repo;
+}
+
+bool git::Tag::isAnnotated() const {
+    return _peeled.annotated;
+}
+
+const git_oid* git::Tag::getTargetId() const {
+    return &_peeled.target;
+}
+
+git_object_t git::Tag::getTargetType() const {
+    return _peeled.type;
+}
+
+git::Tag::Peeled git::Tag::peel(git_repository* repo, const git_oid* id) {
+    git_object* object = nullptr;
+    if (git_object_lookup(&object, repo, id, GIT_OBJECT_ANY) != 0) {
+        throw std::runtime_error("Failed to lookup tag target: " +
+                                 std::string(git_error_last()->message));
+    }
+
+    Peeled peeled;
+    peeled.annotated = git_object_type(object) == GIT_OBJECT_TAG;
+    if (peeled.annotated) {
+        git_object* target = nullptr;
+        int error = git_tag_peel(&target, reinterpret_cast<git_tag*>(object));
+        git_object_free(object);
+        if (error != 0) {
+            throw std::runtime_error("Failed to peel tag: " +
+                                     std::string(git_error_last()->message));
+        }
+        object = target;
+    }
+    peeled.target = *git_object_id(object);
+    peeled.type   = git_object_type(object);
+    git_object_free(object);
+    return peeled;
+}
+
+std::string git::Tag::getPeelPath(Repository* repo) {
+    return std::string(git_repository_path(repo->_repo)) + kPeelFile;
+}
+
+void git::Tag::readPeelTable(Repository* repo, PeelTable& table) {
+    // red: <objekat na koji pokazuje referenca> <oljusten cilj> <tip> <annotated>
+    std::ifstream in(getPeelPath(repo));
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string id, target;
+        int type;
+        Peeled peeled;
+        git_oid key;
+        if (!(fields >> id >> target >> type >> peeled.annotated) ||
+            git_oid_fromstrn(&key, id.data(), id.size()) != 0 ||
+            git_oid_fromstrn(&peeled.target, target.data(), target.size()) != 0) {
+            continue;
+        }
+        peeled.type = static_cast<git_object_t>(type);
+        table[key]  = peeled;
+    }
+}
+
+void git::Tag::writePeelTable(Repository* repo, const PeelTable& table) {
+    std::string path      = getPeelPath(repo);
+    std::string temporary = path + ".lock";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        char hex[GIT_OID_HEXSZ + 1] = {};
+        for (const auto& entry : table) {
+            git_oid_fmt(hex, &entry.first);
+            out << hex << " ";
+            git_oid_fmt(hex, &entry.second.target);
+            out << hex << " " << static_cast<int>(entry.second.type) << " "
+                << entry.second.annotated << "\n";
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to rename " + temporary + " to " + path);
+    }
+}
+
+std::vector<std::unique_ptr<git::Tag>> git::Tag::getAllTags(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    PeelTable table;
+    readPeelTable(repo, table);
+    size_t known = table.size();
+
+    git_reference_iterator* iterator = nullptr;
+    if (git_reference_iterator_glob_new(&iterator, repo->_repo, "refs/tags/*") != 0) {
+        throw std::runtime_error("Failed to create tag iterator.");
+    }
+
+    std::vector<std::unique_ptr<Tag>> tags;
+    git_reference* tagRef = nullptr;
+    try {
+        while (git_reference_next(&tagRef, iterator) == 0) {
+            const git_oid* id = git_reference_target(tagRef);
+            if (!id) {
+                git_reference_free(tagRef);
+                continue;
+            }
+            // samo nove oznake se ljuste; ostale su vec u tabeli
+            auto found = table.find(*id);
+            if (found == table.end()) {
+                found = table.emplace(*id, peel(repo->_repo, id)).first;
+            }
+            tags.push_back(std::unique_ptr<Tag>(new Tag(tagRef, repo, found->second)));
+            tagRef = nullptr;
+            CancellationScope::check();
+        }
+    } catch (...) {
+        git_reference_free(tagRef);
+        git_reference_iterator_free(iterator);
+        throw;
+    }
+    git_reference_iterator_free(iterator);
+
+    if (table.size() != known) {
+        writePeelTable(repo, table);
+    }
+    return tags;
+}
+
+std::unique_ptr<git::Tag> git::Tag::findNearest(const Branch* branch) {
+    if (!branch) {
+        throw std::invalid_argument("Branch is null.");
+    }
+    return findNearest(branch->getRepository(), git_commit_id(branch->getLastCommit()->_commit));
+}
+
+std::unique_ptr<git::Tag> git::Tag::findNearest(Repository* repo, const git_oid* commit) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    // commit -> oznaka; za vise oznaka na istom commit-u prednost ima annotated, pa ime
+    std::vector<std::unique_ptr<Tag>> tags = getAllTags(repo);
+    std::unordered_map<git_oid, size_t, OidHash, OidEqual> tagged;
+    for (size_t i = 0; i < tags.size(); ++i) {
+        if (tags[i]->getTargetType() != GIT_OBJECT_COMMIT) {
+            continue;
+        }
+        auto inserted = tagged.emplace(*tags[i]->getTargetId(), i);
+        const Tag& current = *tags[inserted.first->second];
+        if (!inserted.second &&
+            (tags[i]->isAnnotated() > current.isAnnotated() ||
+             (tags[i]->isAnnotated() == current.isAnnotated() &&
+              tags[i]->getTagName() < current.getTagName()))) {
+            inserted.first->second = i;
+        }
+    }
+    if (tagged.empty()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CommitGraph> graph = CommitGraph::open(repo);
+    auto load = [&](const git_oid* id, std::vector<git_oid>& parents) {
+        WalkEntry entry{CommitGraph::kGenerationInfinity, 0, *id};
+        uint32_t position;
+        if (graph && graph->find(id, &position)) {
+            entry.generation = graph->getGeneration(position);
+            entry.time       = graph->getCommitTime(position);
+            std::vector<uint32_t> positions;
+            graph->getParents(position, positions);
+            for (uint32_t parent : positions) {
+                parents.push_back(graph->getId(parent));
+            }
+            return entry;
+        }
+
+        git_commit* object = nullptr;
+        if (git_commit_lookup(&object, repo->_repo, id) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+        entry.time = static_cast<int64_t>(git_commit_time(object));
+        for (unsigned int i = 0; i < git_commit_parentcount(object); ++i) {
+            parents.push_back(*git_commit_parent_id(object, i));
+        }
+        git_commit_free(object);
+        return entry;
+    };
+
+    // ispod najmanje generacije oznacenih commit-a nijedna oznaka nije dostupna; commit-i
+    // van commit-graph-a (beskonacna generacija) su noviji od svih u njemu
+    uint32_t lowest = CommitGraph::kGenerationInfinity;
+    for (const auto& entry : tagged) {
+        uint32_t position;
+        if (!graph || !graph->find(&entry.first, &position)) {
+            continue;
+        }
+        lowest = std::min(lowest, graph->getGeneration(position));
+    }
+
+    // obilazak po opadajucoj generaciji: roditelj ima manju generaciju od deteta, pa je
+    // prvi oznaceni commit koji izadje iz reda onaj sa najvecom generacijom
+    std::priority_queue<WalkEntry> queue;
+    std::unordered_map<git_oid, std::vector<git_oid>, OidHash, OidEqual> parentsOf;
+    auto push = [&](const git_oid* id) {
+        std::vector<git_oid> parents;
+        queue.push(load(id, parents));
+        parentsOf.emplace(*id, std::move(parents));
+    };
+
+    push(commit);
+    while (!queue.empty()) {
+        WalkEntry entry = queue.top();
+        queue.pop();
+        if (entry.generation < lowest) {
+            break;
+        }
+
+        auto found = tagged.find(entry.id);
+        if (found != tagged.end()) {
+            return std::move(tags[found->second]);
+        }
+
+        std::vector<git_oid> parents = parentsOf[entry.id];
+        for (const git_oid& parent : parents) {
+            if (parentsOf.find(parent) == parentsOf.end()) {
+                push(&parent);
+            }
+        }
+        CancellationScope::check();
+    }
+    return nullptr;
+}
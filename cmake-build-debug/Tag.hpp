@@ -0,0 +1,76 @@
+#ifndef PROBA_TAG_HPP
+#define PROBA_TAG_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class Repository;
+
+// oznaka (refs/tags/*), par za Branch; cilj oznake je vec oljusten (annotated oznake do
+// objekta na koji pokazuju), a tabela oljustenih ciljeva se cuva u "proba-tag-peel":
+// objekti oznaka su nepromenljivi, pa se svaka oznaka ljusti samo jednom
+class Tag {
+public:
+    static constexpr const char* kPeelFile = "proba-tag-peel";
+
+    Tag(const Tag&)            = delete;
+    Tag& operator=(const Tag&) = delete;
+    ~Tag();
+
+    static std::vector<std::unique_ptr<Tag>> getAllTags(Repository* repo);
+
+    // preuzima vlasnistvo nad referencom
+    static std::unique_ptr<Tag> create(git_reference* tag, Repository* repo);
+
+    // najbliza oznaka dostupna iz vrha grane (commit sa najvecom generacijom, kao describe
+    // bez brojanja); nullptr ako nijedna oznaka nije dostupna
+    static std::unique_ptr<Tag> findNearest(const Branch* branch);
+    static std::unique_ptr<Tag> findNearest(Repository* repo, const git_oid* commit);
+
+    std::string getTagName() const;
+    Repository* getRepository() const;
+
+    bool isAnnotated() const;
+    // oljusten cilj: commit za uobicajene oznake
+    const git_oid* getTargetId() const;
+    git_object_t getTargetType() const;
+
+private:
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+
+    struct Peeled {
+        git_oid target;
+        git_object_t type;
+        bool annotated;
+    };
+
+    typedef std::unordered_map<git_oid, Peeled, OidHash, OidEqual> PeelTable;
+
+    Tag(git_reference* tag, Repository* repo, const Peeled& peeled);
+
+    static Peeled peel(git_repository* repo, const git_oid* id);
+    static std::string getPeelPath(Repository* repo);
+    static void readPeelTable(Repository* repo, PeelTable& table);
+    static void writePeelTable(Repository* repo, const PeelTable& table);
+
+    git_reference* _tag;
+    Repository* _repo;
+    Peeled _peeled;
+};
+
+}
+
+#endif
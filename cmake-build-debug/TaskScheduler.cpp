@@ -0,0 +1,191 @@
+#include "TaskScheduler.hpp"
+
+#include "Branch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+struct ThreadContext {
+    const git::TaskScheduler* scheduler = nullptr;
+    size_t index                        = 0;
+    git_repository* repo                = nullptr;
+};
+
+thread_local ThreadContext currentContext;
+
+}
+
+git::TaskScheduler::TaskScheduler(Repository* repo, unsigned threads) : _repo(repo) {
+    std::string path = git_repository_path(repo->_repo);
+    for (unsigned i = 0; i < threads; ++i) {
+        std::unique_ptr<Worker> worker(new Worker());
+        // sopstveni handle po niti; ako otvaranje ne uspe, nit koristi zajednicki
+        if (git_repository_open_ext(&worker->repo, path.c_str(), GIT_REPOSITORY_OPEN_NO_SEARCH,
+                                    nullptr) != 0) {
+            worker->repo = nullptr;
+        }
+        _workers.push_back(std::move(worker));
+    }
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->thread = std::thread(&TaskScheduler::work, this, i);
+    }
+}
+
+git::TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& worker : _workers) {
+        worker->thread.join();
+        if (worker->repo) {
+            git_repository_free(worker->repo);
+        }
+    }
+}
+
+std::unique_ptr<git::TaskScheduler> git::TaskScheduler::create(Repository* repo,
+                                                              unsigned threads) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return std::unique_ptr<TaskScheduler>(new TaskScheduler(repo, threads));
+}
+
+unsigned git::TaskScheduler::getThreadCount() const {
+    return static_cast<unsigned>(_workers.size());
+}
+
+int git::TaskScheduler::currentWorker() const {
+    return currentContext.scheduler == this ? static_cast<int>(currentContext.index) : -1;
+}
+
+git_repository* git::TaskScheduler::getThreadRepository() const {
+    if (currentContext.scheduler == this && currentContext.repo) {
+        return currentContext.repo;
+    }
+    return _repo->_repo;
+}
+
+void git::TaskScheduler::submit(Task task) {
+    // iz radne niti posao ide u sopstveni red (lokalnost), inace redom po nitima
+    int current  = currentWorker();
+    size_t index = current >= 0 ? static_cast<size_t>(current) : _next++ % _workers.size();
+    {
+        std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+        _workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_queued;
+    }
+    _wake.notify_one();
+}
+
+bool git::TaskScheduler::pop(size_t index, Task* task) {
+    Worker& worker = *_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool git::TaskScheduler::steal(size_t index, Task* task) {
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        Worker& victim = *_workers[(index + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void git::TaskScheduler::work(size_t index) {
+    currentContext.scheduler = this;
+    currentContext.index     = index;
+    currentContext.repo      = _workers[index]->repo;
+
+    Task task;
+    while (true) {
+        if (pop(index, &task) || steal(index, &task)) {
+            --_queued;
+            try {
+                task();
+            } catch (...) {
+                // parallelFor prenosi izuzetke sam; ostali poslovi ih ne smeju pustiti u nit
+            }
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wake.wait(lock, [this]() { return _stopping || _queued > 0; });
+        if (_stopping && _queued == 0) {
+            break;
+        }
+    }
+    currentContext = ThreadContext();
+}
+
+void git::TaskScheduler::parallelFor(size_t count, size_t grain,
+                                     const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grain         = std::max<size_t>(grain, 1);
+    size_t chunks = (count + grain - 1) / grain;
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t finished = 0;
+        std::exception_ptr error;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    // delovi se uzimaju preko brojaca, pa pomocni posao koji krene kasno samo izadje
+    auto run = [shared, chunks, count, grain, &body]() {
+        size_t chunk;
+        while ((chunk = shared->next++) < chunks) {
+            std::exception_ptr error;
+            try {
+                body(chunk * grain, std::min(count, (chunk + 1) * grain));
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (error && !shared->error) {
+                shared->error = error;
+            }
+            if (++shared->finished == chunks) {
+                shared->done.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(chunks - 1, _workers.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->done.wait(lock, [&]() { return shared->finished == chunks; });
+    if (shared->error) {
+        std::rethrow_exception(shared->error);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef PROBA_TASKSCHEDULER_HPP
+#define PROBA_TASKSCHEDULER_HPP
+
+#include <git2.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace git {
+
+class Repository;
+
+// skup niti koji dele masovne operacije nad jednim repozitorijumom (delta pretraga, provera
+// objekata, upis checkout-a, ...), umesto da svaka pravi svoje niti; svaka nit ima svoj red
+// (LIFO za sopstvene poslove) i krade sa pocetka tudjih redova kada ostane bez posla; svaka
+// nit ima i sopstveni git_repository handle, pa libgit2 kesevi nisu deljeni izmedju niti;
+// scheduler pravi i drzi pozivalac i mora ga unistiti pre Repository-ja
+class TaskScheduler {
+public:
+    typedef std::function<void()> Task;
+
+    TaskScheduler(const TaskScheduler&)            = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    ~TaskScheduler();
+
+    static std::unique_ptr<TaskScheduler> create(Repository* repo, unsigned threads = 0);
+
+    void submit(Task task);
+
+    // body(begin, end) nad [0, count) u delovima velicine grain; pozivalac i sam obradjuje
+    // delove, pa je poziv iz posla koji vec radi na scheduler-u bezbedan; prvi izuzetak
+    // se ponovo baca posle zavrsetka svih delova
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t begin, size_t end)>& body);
+
+    // handle za tekucu nit: sopstveni u nitima scheduler-a, inace repo->_repo
+    git_repository* getThreadRepository() const;
+
+    unsigned getThreadCount() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        git_repository* repo = nullptr;
+        std::thread thread;
+    };
+
+    TaskScheduler(Repository* repo, unsigned threads);
+
+    void work(size_t index);
+    bool pop(size_t index, Task* task);
+    bool steal(size_t index, Task* task);
+    int currentWorker() const;
+
+    Repository* _repo;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<size_t> _next{0};
+    std::atomic<size_t> _queued{0};
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    bool _stopping = false;
+};
+
+}
+
+#endif
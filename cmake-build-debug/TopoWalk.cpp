@@ -0,0 +1,165 @@
+#include "TopoWalk.hpp"
+
+#include "Branch.hpp"
+#include "CommitGraph.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+size_t git::TopoWalk::OidHash::operator()(const git_oid& oid) const {
+    size_t hash;
+    std::memcpy(&hash, oid.id, sizeof(hash));
+    return hash;
+}
+
+bool git::TopoWalk::OidEqual::operator()(const git_oid& a, const git_oid& b) const {
+    return git_oid_equal(&a, &b);
+}
+
+bool git::TopoWalk::Pending::operator<(const Pending& other) const {
+    // najveca generacija prva, pa najnovije vreme
+    if (generation != other.generation) {
+        return generation < other.generation;
+    }
+    if (time != other.time) {
+        return time < other.time;
+    }
+    return std::memcmp(oid.id, other.oid.id, GIT_OID_RAWSZ) < 0;
+}
+
+git::TopoWalk::TopoWalk(Repository* repo)
+    : _repo(repo), _minGeneration(CommitGraph::kGenerationInfinity) {}
+
+git::TopoWalk::~TopoWalk() = default;
+
+std::unique_ptr<git::TopoWalk> git::TopoWalk::create(Repository* repo) {
+    if (!repo) {
+        throw std::invalid_argument("Repository is null.");
+    }
+
+    std::unique_ptr<TopoWalk> walk(new TopoWalk(repo));
+    walk->_graph = CommitGraph::open(repo);
+    return walk;
+}
+
+void git::TopoWalk::push(const git_oid* tip) {
+    if (_started) {
+        throw std::logic_error("Cannot add tips after the walk has started.");
+    }
+    for (const git_oid& existing : _tips) {
+        if (git_oid_equal(&existing, tip)) {
+            return;
+        }
+    }
+    _tips.push_back(*tip);
+}
+
+void git::TopoWalk::push(const Branch* branch) {
+    if (!branch) {
+        throw std::invalid_argument("Branch is null.");
+    }
+    push(git_commit_id(branch->getLastCommit()->_commit));
+}
+
+size_t git::TopoWalk::getVisitedCount() const {
+    return _nodes.size();
+}
+
+git::TopoWalk::Node& git::TopoWalk::load(const git_oid* oid) {
+    auto found = _nodes.find(*oid);
+    if (found != _nodes.end()) {
+        return found->second;
+    }
+
+    Node node;
+    uint32_t position;
+    if (_graph && _graph->find(oid, &position)) {
+        node.generation = _graph->getGeneration(position);
+        node.time       = _graph->getCommitTime(position);
+        std::vector<uint32_t> parents;
+        _graph->getParents(position, parents);
+        for (uint32_t parent : parents) {
+            node.parents.push_back(_graph->getId(parent));
+        }
+    } else {
+        // commit noviji od grafa: generacija ostaje beskonacna, pa ga obilazak uvek obradi
+        git_commit* commit = nullptr;
+        if (git_commit_lookup(&commit, _repo->_repo, oid) != 0) {
+            throw std::runtime_error("Failed to lookup commit: " +
+                                     std::string(git_error_last()->message));
+        }
+        node.generation = CommitGraph::kGenerationInfinity;
+        node.time       = static_cast<int64_t>(git_commit_time(commit));
+        for (unsigned int i = 0; i < git_commit_parentcount(commit); ++i) {
+            node.parents.push_back(*git_commit_parent_id(commit, i));
+        }
+        git_commit_free(commit);
+    }
+    return _nodes.emplace(*oid, std::move(node)).first->second;
+}
+
+void git::TopoWalk::start() {
+    _started = true;
+    for (const git_oid& tip : _tips) {
+        Node& node = load(&tip);
+        node.indegree = 1;
+        _indegreeQueue.push({node.generation, node.time, tip});
+        _minGeneration = std::min(_minGeneration, node.generation);
+    }
+    computeIndegrees(_minGeneration);
+
+    // stek: prvi dodati vrh se vraca prvi; vrh koji je potomak drugog vrha ceka svoj red
+    for (size_t i = _tips.size(); i-- > 0;) {
+        if (load(&_tips[i]).indegree == 1) {
+            _topoStack.push_back(_tips[i]);
+        }
+    }
+}
+
+void git::TopoWalk::computeIndegrees(uint32_t cutoff) {
+    // svi potomci commit-a generacije >= cutoff imaju vecu generaciju, pa su do kraja
+    // petlje svi vec prebrojani i ulazni stepen takvog commit-a je konacan
+    while (!_indegreeQueue.empty() && _indegreeQueue.top().generation >= cutoff) {
+        git_oid oid = _indegreeQueue.top().oid;
+        _indegreeQueue.pop();
+
+        std::vector<git_oid> parents = load(&oid).parents;
+        for (const git_oid& parentId : parents) {
+            Node& parent = load(&parentId);
+            if (parent.indegree) {
+                ++parent.indegree;
+            } else {
+                parent.indegree = 2;
+                _indegreeQueue.push({parent.generation, parent.time, parentId});
+            }
+        }
+    }
+}
+
+bool git::TopoWalk::next(git_oid* oid) {
+    if (!_started) {
+        start();
+    }
+    if (_topoStack.empty()) {
+        return false;
+    }
+
+    *oid = _topoStack.back();
+    _topoStack.pop_back();
+
+    Node& node    = load(oid);
+    node.indegree = 0;
+    std::vector<git_oid> parents = node.parents;
+    for (const git_oid& parentId : parents) {
+        Node& parent = load(&parentId);
+        if (parent.generation < _minGeneration) {
+            _minGeneration = parent.generation;
+            computeIndegrees(_minGeneration);
+        }
+        if (--parent.indegree == 1) {
+            _topoStack.push_back(parentId);
+        }
+    }
+    return true;
+}
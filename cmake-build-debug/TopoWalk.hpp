@@ -0,0 +1,82 @@
+#ifndef PROBA_TOPOWALK_HPP
+#define PROBA_TOPOWALK_HPP
+
+#include <git2.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace git {
+
+class Branch;
+class CommitGraph;
+class Repository;
+
+// inkrementalni topoloski redosled (kao git log --topo-order): commit se vraca tek kada su
+// vraceni svi njegovi potomci medju vrhovima, ali se ulazni stepeni racunaju samo do
+// najmanje generacije koju je obilazak dostigao, umesto da se prvo prodje cela istorija;
+// bez commit-graph-a generacija je beskonacna i obilazak se svodi na pun prolaz
+class TopoWalk {
+public:
+    TopoWalk(const TopoWalk&)            = delete;
+    TopoWalk& operator=(const TopoWalk&) = delete;
+    ~TopoWalk();
+
+    static std::unique_ptr<TopoWalk> create(Repository* repo);
+
+    // vrhovi se dodaju pre prvog next(); redosled dodavanja odredjuje koja grana ide prva
+    void push(const git_oid* tip);
+    void push(const Branch* branch);
+
+    // false kada vise nema commit-a
+    bool next(git_oid* oid);
+
+    // koliko je commit-a do sada ucitano (graf ili parsiranje), za merenje obilaska
+    size_t getVisitedCount() const;
+
+private:
+    struct OidHash {
+        size_t operator()(const git_oid& oid) const;
+    };
+    struct OidEqual {
+        bool operator()(const git_oid& a, const git_oid& b) const;
+    };
+
+    struct Node {
+        uint32_t generation = 0;
+        int64_t time        = 0;
+        // 0: jos nije vidjen ili je vracen; inace 1 + broj nevracenih vidjenih potomaka
+        uint32_t indegree = 0;
+        std::vector<git_oid> parents;
+    };
+
+    struct Pending {
+        uint32_t generation;
+        int64_t time;
+        git_oid oid;
+        bool operator<(const Pending& other) const;
+    };
+
+    explicit TopoWalk(Repository* repo);
+
+    Node& load(const git_oid* oid);
+    void start();
+    void computeIndegrees(uint32_t cutoff);
+
+    Repository* _repo;
+    std::unique_ptr<CommitGraph> _graph;
+    std::unordered_map<git_oid, Node, OidHash, OidEqual> _nodes;
+    std::vector<git_oid> _tips;
+    std::priority_queue<Pending> _indegreeQueue;
+    std::vector<git_oid> _topoStack;
+    uint32_t _minGeneration;
+    bool _started = false;
+};
+
+}
+
+#endif